@@ -0,0 +1,62 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo.hpp"
+#include "sl/exec/coro.hpp"
+#include "sl/exec/model.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace sl::exec {
+namespace {
+
+constexpr std::size_t await_count = 1024;
+
+// symmetric transfer between async frames, no executor round-trip
+void BM_asyncAwait(benchmark::State& state) {
+    manual_executor executor;
+    std::size_t counter = 0;
+
+    auto inner = [] -> async<std::size_t> { co_return 1; };
+    auto outer = [&counter, inner] -> async<void> {
+        for (std::size_t i = 0; i != await_count; ++i) {
+            counter += co_await inner();
+        }
+    };
+
+    for (auto _ : state) {
+        coro_schedule(executor, outer());
+        executor.execute_batch();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * await_count));
+}
+BENCHMARK(BM_asyncAwait);
+
+// every await hops through the executor and back
+void BM_asyncResume(benchmark::State& state) {
+    manual_executor executor;
+    std::size_t counter = 0;
+
+    auto outer = [&counter, &executor] -> async<void> {
+        for (std::size_t i = 0; i != await_count; ++i) {
+            co_await start_on(executor);
+            ++counter;
+        }
+    };
+
+    for (auto _ : state) {
+        coro_schedule(executor, outer());
+        while (executor.execute_batch() > 0) {
+        }
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * await_count));
+}
+BENCHMARK(BM_asyncResume);
+
+} // namespace
+} // namespace sl::exec
@@ -0,0 +1,114 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo.hpp"
+#include "sl/exec/model.hpp"
+#include "sl/exec/thread.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace sl::exec {
+namespace {
+
+constexpr std::size_t batch_size = 1024;
+
+struct counting_task final : task_node {
+    void execute() noexcept override { counter->fetch_add(1, std::memory_order::relaxed); }
+    void cancel() noexcept override {}
+
+    detail::atomic<std::size_t>* counter = nullptr;
+};
+
+std::vector<counting_task> make_tasks(detail::atomic<std::size_t>& counter) {
+    std::vector<counting_task> tasks(batch_size);
+    for (auto& task : tasks) {
+        task.counter = &counter;
+    }
+    return tasks;
+}
+
+void BM_manualScheduleExecute(benchmark::State& state) {
+    manual_executor executor;
+    detail::atomic<std::size_t> counter{ 0 };
+    auto tasks = make_tasks(counter);
+
+    for (auto _ : state) {
+        for (auto& task : tasks) {
+            executor.schedule(task);
+        }
+        executor.execute_batch();
+    }
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+}
+BENCHMARK(BM_manualScheduleExecute);
+
+void BM_monolithicScheduleExecute(benchmark::State& state) {
+    monolithic_thread_pool pool{ thread_pool_config::with_hw_limit(static_cast<std::uint32_t>(state.range(0))) };
+    detail::atomic<std::size_t> counter{ 0 };
+    auto tasks = make_tasks(counter);
+
+    for (auto _ : state) {
+        for (auto& task : tasks) {
+            pool.schedule(task);
+        }
+        pool.wait_idle();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+}
+BENCHMARK(BM_monolithicScheduleExecute)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+void BM_scheduleSignal(benchmark::State& state) {
+    manual_executor executor;
+    std::size_t counter = 0;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i != batch_size; ++i) {
+            schedule(executor, [&counter] -> meta::result<meta::unit, meta::undefined> {
+                ++counter;
+                return meta::ok(meta::unit{});
+            }) | detach();
+        }
+        executor.execute_batch();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+}
+BENCHMARK(BM_scheduleSignal);
+
+// every producer thread schedules onto the same strand
+void BM_serialContention(benchmark::State& state) {
+    const auto producer_count = static_cast<std::size_t>(state.range(0));
+    monolithic_thread_pool pool{ thread_pool_config::with_hw_limit(2u) };
+    serial_executor serial{ pool };
+    std::size_t counter = 0;
+
+    for (auto _ : state) {
+        std::vector<std::thread> producers;
+        for (std::size_t p = 0; p != producer_count; ++p) {
+            producers.emplace_back([&serial, &counter] {
+                for (std::size_t i = 0; i != batch_size; ++i) {
+                    schedule(serial, [&counter] -> meta::result<meta::unit, meta::undefined> {
+                        ++counter;
+                        return meta::ok(meta::unit{});
+                    }) | detach();
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        pool.wait_idle();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * producer_count * batch_size));
+}
+BENCHMARK(BM_serialContention)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+} // namespace
+} // namespace sl::exec
@@ -0,0 +1,118 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo.hpp"
+#include "sl/exec/model.hpp"
+#include "sl/exec/thread.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace sl::exec {
+namespace {
+
+// rendezvous on a single thread, both sides complete inline
+void BM_channelPingPong(benchmark::State& state) {
+    auto ping = make_channel<int>();
+    auto pong = make_channel<int>();
+    int sum = 0;
+
+    for (auto _ : state) {
+        ping->receive() //
+            | map([&pong](int value) {
+                  pong->send(value + 1) | detach();
+                  return meta::unit{};
+              })
+            | detach();
+        ping->send(1) | detach();
+        sum += (pong->receive() | get<nowait_event>())->value();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2));
+}
+BENCHMARK(BM_channelPingPong);
+
+// N producers and N consumers, every one of them blocks on its own operation
+void BM_channelNPNC(benchmark::State& state) {
+    const auto pair_count = static_cast<std::size_t>(state.range(0));
+    constexpr std::size_t messages = 1024;
+    auto channel = make_channel<std::size_t>();
+
+    for (auto _ : state) {
+        detail::atomic<std::size_t> sum{ 0 };
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p != pair_count; ++p) {
+            threads.emplace_back([&channel] {
+                for (std::size_t i = 0; i != messages; ++i) {
+                    channel->send(std::size_t{ i }) | get<default_event>();
+                }
+            });
+            threads.emplace_back([&channel, &sum] {
+                for (std::size_t i = 0; i != messages; ++i) {
+                    const auto result = channel->receive() | get<default_event>();
+                    sum.fetch_add(result->value(), std::memory_order::relaxed);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(sum.load());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * pair_count * messages));
+}
+BENCHMARK(BM_channelNPNC)->RangeMultiplier(2)->Range(1, 4)->UseRealTime();
+
+// from the send on the second channel to the select handler
+void BM_selectLatency(benchmark::State& state) {
+    auto channel1 = make_channel<int>();
+    auto channel2 = make_channel<int>();
+    int sum = 0;
+
+    for (auto _ : state) {
+        select()
+                .case_(
+                    channel1->receive(),
+                    [&sum](int value) {
+                        sum += value;
+                        return meta::unit{};
+                    }
+                )
+                .case_(
+                    channel2->receive(),
+                    [&sum](int value) {
+                        sum -= value;
+                        return meta::unit{};
+                    }
+                )
+            | detach();
+        channel2->send(1) | detach();
+    }
+    benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_selectLatency);
+
+void BM_mutexUncontended(benchmark::State& state) {
+    manual_executor executor;
+    mutex m{ executor };
+    std::size_t counter = 0;
+
+    for (auto _ : state) {
+        m.lock() //
+            | map([&counter](mutex_lock lock) {
+                  ++counter;
+                  return std::move(lock).unlock();
+              })
+            | flatten() //
+            | detach();
+    }
+    benchmark::DoNotOptimize(counter);
+}
+BENCHMARK(BM_mutexUncontended);
+
+} // namespace
+} // namespace sl::exec
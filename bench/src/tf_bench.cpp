@@ -0,0 +1,122 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo.hpp"
+#include "sl/exec/model.hpp"
+#include "sl/exec/thread.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace sl::exec {
+namespace {
+
+void BM_allFanOut2(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = all(value_as_signal(1), value_as_signal(2)) | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_allFanOut2);
+
+void BM_allFanOut8(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = all(
+                          value_as_signal(1),
+                          value_as_signal(2),
+                          value_as_signal(3),
+                          value_as_signal(4),
+                          value_as_signal(5),
+                          value_as_signal(6),
+                          value_as_signal(7),
+                          value_as_signal(8)
+                      )
+                      | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_allFanOut8);
+
+void BM_anyFanOut2(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = any(value_as_signal(1), value_as_signal(2)) | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_anyFanOut2);
+
+void BM_anyFanOut8(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = any(
+                          value_as_signal(1),
+                          value_as_signal(2),
+                          value_as_signal(3),
+                          value_as_signal(4),
+                          value_as_signal(5),
+                          value_as_signal(6),
+                          value_as_signal(7),
+                          value_as_signal(8)
+                      )
+                      | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_anyFanOut8);
+
+void BM_whenAllRange(benchmark::State& state) {
+    const auto shard_count = static_cast<std::size_t>(state.range(0));
+    using signal_type = decltype(value_as_signal(0));
+    for (auto _ : state) {
+        std::vector<signal_type> signals;
+        signals.reserve(shard_count);
+        for (std::size_t i = 0; i != shard_count; ++i) {
+            signals.push_back(value_as_signal(static_cast<int>(i)));
+        }
+        auto result = when_all(std::move(signals)) | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_whenAllRange)->RangeMultiplier(4)->Range(8, 512);
+
+// baseline for share and fork
+void BM_mapChain(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = value_as_signal(1) //
+                      | map([](int x) { return x + 1; }) //
+                      | map([](int x) { return x * 2; }) //
+                      | map([](int x) { return x - 3; }) //
+                      | get<nowait_event>();
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_mapChain);
+
+void BM_share(benchmark::State& state) {
+    const auto subscriber_count = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        meta::maybe<share_box<int, meta::undefined>> maybe_shared{ value_as_signal(42) | share() };
+        for (std::size_t i = 0; i != subscriber_count; ++i) {
+            auto result = maybe_shared->get_signal() | get<nowait_event>();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+BENCHMARK(BM_share)->RangeMultiplier(2)->Range(1, 8);
+
+void BM_fork(benchmark::State& state) {
+    for (auto _ : state) {
+        auto [l_signal, r_signal] = value_as_signal(42) | fork();
+        auto l_result = std::move(l_signal) | get<nowait_event>();
+        auto r_result = std::move(r_signal) | get<nowait_event>();
+        benchmark::DoNotOptimize(l_result);
+        benchmark::DoNotOptimize(r_result);
+    }
+}
+BENCHMARK(BM_fork);
+
+} // namespace
+} // namespace sl::exec
@@ -0,0 +1,43 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/multiword_kcas.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace sl::exec {
+namespace {
+
+constexpr std::size_t kcas_word_count = 4;
+
+// shared between the benchmark threads
+detail::atomic<std::size_t> kcas_words[kcas_word_count]{};
+
+// every thread increments all of the words at once, so operations always conflict
+void BM_kcasScaling(benchmark::State& state) {
+    std::size_t failures = 0;
+    for (auto _ : state) {
+        while (true) {
+            const auto increment = [](detail::atomic<std::size_t>& word) {
+                const std::size_t value = detail::kcas_read(word);
+                return detail::kcas_arg<std::size_t>{ .a = &word, .e = value, .n = value + 1 };
+            };
+            const bool success = detail::kcas(
+                increment(kcas_words[0]), increment(kcas_words[1]), increment(kcas_words[2]), increment(kcas_words[3])
+            );
+            if (success) {
+                break;
+            }
+            ++failures;
+        }
+    }
+    state.counters["failures"] = benchmark::Counter(static_cast<double>(failures), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_kcasScaling)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+} // namespace sl::exec
@@ -7,5 +7,6 @@
 #include "sl/exec/algo/emit.hpp"
 #include "sl/exec/algo/make.hpp"
 #include "sl/exec/algo/sched.hpp"
+#include "sl/exec/algo/stream.hpp"
 #include "sl/exec/algo/sync.hpp"
 #include "sl/exec/algo/tf.hpp"
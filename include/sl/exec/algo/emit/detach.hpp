@@ -17,9 +17,18 @@ struct [[nodiscard]] detach_connection final {
     struct detach_slot final {
         detach_connection* self;
 
-        constexpr void set_value(value_type&&) && noexcept { delete self; }
-        constexpr void set_error(error_type&&) && noexcept { delete self; }
-        constexpr void set_null() && noexcept { delete self; }
+        constexpr void set_value(value_type&&) && noexcept {
+            detail::trace_slot("detach", "set_value");
+            delete self;
+        }
+        constexpr void set_error(error_type&&) && noexcept {
+            detail::trace_slot("detach", "set_error");
+            delete self;
+        }
+        constexpr void set_null() && noexcept {
+            detail::trace_slot("detach", "set_null");
+            delete self;
+        }
     };
 
     struct detach_slot_ctor final {
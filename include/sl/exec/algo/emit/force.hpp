@@ -1,6 +1,7 @@
 //
 // Created by usatiynyan.
-// NOTE: `force()` on a signal breaks propagation of `try_cancel()`
+// `try_cancel()` is forwarded to the forced signal.
+// The storage is deleted after both the result is delivered and the subscribed connection lets go of it.
 //
 
 #pragma once
@@ -10,7 +11,9 @@
 #include "sl/exec/thread/detail/atomic.hpp"
 
 #include <bit>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 namespace sl::exec {
 namespace detail {
@@ -47,12 +50,22 @@ struct force_storage {
     };
 
     using callback_type = slot_callback<value_type, error_type>;
+    using connection_type = ConnectionFor<SignalT, slot_ctor>;
+    using cancel_handle_type = decltype(std::declval<connection_type&&>().emit());
 
 public:
     explicit force_storage(SignalT&& signal) : connection_{ std::move(signal).subscribe(slot_ctor{ *this }) } {
-        // if the signal is "forced" it loses it's ability to be cancelled
-        // otherwise - it's hard to keep track of lifetimes
-        std::ignore = std::move(connection_).emit();
+        // the storage can't be deleted until there's a slot callback
+        cancel_handle_.emplace(std::move(connection_).emit());
+    }
+
+    // by the subscribed connection, which still holds its reference
+    void try_cancel() noexcept { std::move(*cancel_handle_).try_cancel(); }
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
     }
 
     void set_result(meta::maybe<result_type> result) {
@@ -66,7 +79,7 @@ public:
         auto* a_slot_callback = std::bit_cast<callback_type*>(curr_state);
 
         std::move(*a_slot_callback).set_result(std::move(maybe_result_));
-        delete this;
+        release();
     }
 
     void set_slot_callback(callback_type& a_slot_callback) {
@@ -82,25 +95,39 @@ public:
         }
 
         std::move(a_slot_callback).set_result(std::move(maybe_result_));
-        delete this;
+        release();
     }
 
 private:
-    ConnectionFor<SignalT, slot_ctor> connection_;
+    connection_type connection_;
+    meta::maybe<cancel_handle_type> cancel_handle_;
     meta::maybe<result_type> maybe_result_;
     Atomic<std::uintptr_t> state_{ state_empty };
+    // the delivered result and the subscribed connection
+    Atomic<std::uint32_t> refs_{ 2 };
 };
 
 template <SomeSignal SignalT, SlotCtorFor<SignalT> SlotCtorT, template <typename> typename Atomic>
 struct force_connection final : slot_callback<typename SignalT::value_type, typename SignalT::error_type> {
     force_connection(SlotCtorT&& slot_ctor, std::unique_ptr<force_storage<SignalT, Atomic>> storage)
         : slot_{ std::move(slot_ctor)() }, storage_{ std::move(storage) } {}
+    force_connection(force_connection&& other) noexcept
+        : slot_{ std::move(other.slot_) }, storage_{ std::move(other.storage_) },
+          emitted_{ std::exchange(other.emitted_, nullptr) } {}
+    ~force_connection() noexcept override {
+        if (emitted_ != nullptr) {
+            emitted_->release();
+        }
+    }
 
     CancelHandle auto emit() && noexcept {
-        storage_.release()->set_slot_callback(*this);
-        return dummy_cancel_handle();
+        emitted_ = storage_.release();
+        emitted_->set_slot_callback(*this);
+        return proxy_cancel_handle{ this };
     }
 
+    void try_cancel() && noexcept { emitted_->try_cancel(); }
+
     void set_result(meta::maybe<ForSignal<meta::result, SignalT>>&& maybe_result) && noexcept override {
         fulfill_slot(std::move(slot_), std::move(maybe_result));
     }
@@ -108,6 +135,7 @@ struct force_connection final : slot_callback<typename SignalT::value_type, type
 private:
     SlotFrom<SlotCtorT> slot_;
     std::unique_ptr<force_storage<SignalT, Atomic>> storage_;
+    force_storage<SignalT, Atomic>* emitted_ = nullptr;
 };
 
 template <SomeSignal SignalT, template <typename> typename Atomic>
@@ -20,14 +20,19 @@ struct get_slot final {
 
 public:
     void set_value(V&& value) && noexcept {
+        detail::trace_slot("get", "set_value");
         maybe_result.emplace(meta::ok_tag, std::move(value));
         event.set();
     }
     void set_error(E&& error) && noexcept {
+        detail::trace_slot("get", "set_error");
         maybe_result.emplace(meta::err_tag, std::move(error));
         event.set();
     }
-    void set_null() && noexcept { event.set(); }
+    void set_null() && noexcept {
+        detail::trace_slot("get", "set_null");
+        event.set();
+    }
 };
 
 template <Event EventT>
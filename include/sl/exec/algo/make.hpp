@@ -7,6 +7,7 @@
 #include "sl/exec/algo/make/as_signal.hpp"
 #include "sl/exec/algo/make/result.hpp"
 
+#include "sl/exec/algo/make/data_parallel.hpp"
 #include "sl/exec/algo/make/schedule.hpp"
 
 #include "sl/exec/algo/make/contract.hpp"
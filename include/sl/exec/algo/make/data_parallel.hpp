@@ -0,0 +1,443 @@
+//
+// Created by usatiynyan.
+// Data-parallel algorithms on top of any executor: `parallel_for`, `parallel_reduce`, `parallel_inclusive_scan`.
+//
+// The range is cut into chunks of `grain` elements (0 picks the grain from the range size and the concurrency hint
+// of the executor, hardware concurrency if it has none),
+// then chunk ranges are split recursively: the right half is scheduled, so that idle workers can pick it up,
+// the left one is processed in place. Chunk results are combined in the original order, so `op` has to be
+// associative, but not necessarily commutative.
+// The result is delivered inline by whoever processes the last chunk, `try_cancel()` skips the remaining chunks.
+//
+
+#pragma once
+
+#include "sl/exec/algo/sync/detail/parallel.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/type/undefined.hpp>
+#include <sl/meta/type/unit.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+inline std::size_t data_parallel_grain(std::size_t size, std::size_t grain, std::size_t concurrency) noexcept {
+    if (grain != 0) {
+        return grain;
+    }
+    // a few chunks per worker is enough to balance uneven chunks w/o drowning in tasks
+    constexpr std::size_t chunks_per_worker = 8;
+    const std::size_t workers =
+        concurrency != 0 ? concurrency : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    return std::max<std::size_t>(1, size / (workers * chunks_per_worker));
+}
+
+template <template <typename> typename Atomic>
+struct data_parallel_base {
+    struct chunk_task final : task_node {
+        chunk_task(data_parallel_base& self, std::size_t first, std::size_t last)
+            : self_{ self }, first_{ first }, last_{ last } {}
+
+        void execute() noexcept override {
+            auto& self = self_;
+            const std::size_t first = first_;
+            const std::size_t last = last_;
+            delete this;
+            self.run(first, last);
+        }
+        void cancel() noexcept override {
+            auto& self = self_;
+            const std::size_t count = last_ - first_;
+            delete this;
+            // skipped chunks leave the result incomplete
+            self.request_cancel();
+            self.complete(count);
+        }
+
+    private:
+        data_parallel_base& self_;
+        std::size_t first_;
+        std::size_t last_;
+    };
+
+public:
+    data_parallel_base(executor& an_executor, std::size_t size, std::size_t grain)
+        : executor_{ an_executor }, size_{ size },
+          grain_{ data_parallel_grain(size, grain, an_executor.concurrency_hint()) },
+          chunk_count_{ (size_ + grain_ - 1) / grain_ } {}
+    virtual ~data_parallel_base() = default;
+
+    data_parallel_base(const data_parallel_base&) = delete;
+    data_parallel_base& operator=(const data_parallel_base&) = delete;
+
+    // over [first, last) of the chunk `index`
+    virtual void process_chunk(std::size_t index, std::size_t first, std::size_t last) noexcept = 0;
+    // once all the chunks of a pass are processed (or skipped)
+    virtual void finish_pass() noexcept = 0;
+
+public:
+    void start_pass() noexcept {
+        if (chunk_count_ == 0) {
+            finish_pass();
+            return;
+        }
+        remaining_.store(chunk_count_, std::memory_order::relaxed);
+        executor_.schedule(*new chunk_task{ *this, 0, chunk_count_ });
+    }
+
+    void request_cancel() noexcept { is_cancelled_.store(true, std::memory_order::relaxed); }
+    [[nodiscard]] bool is_cancelled() const noexcept { return is_cancelled_.load(std::memory_order::relaxed); }
+
+    std::size_t chunk_count() const noexcept { return chunk_count_; }
+
+    // called once after the result is delivered and once by the owner
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+private:
+    void run(std::size_t first, std::size_t last) noexcept {
+        while (last - first > 1) {
+            const std::size_t middle = first + (last - first) / 2;
+            executor_.schedule(*new chunk_task{ *this, middle, last });
+            last = middle;
+        }
+        if (!is_cancelled()) {
+            process_chunk(first, first * grain_, std::min(size_, (first + 1) * grain_));
+        }
+        complete(1);
+    }
+
+    void complete(std::size_t count) noexcept {
+        // synchronizes chunk results w/ the one that finishes
+        if (remaining_.fetch_sub(count, std::memory_order::acq_rel) == count) {
+            finish_pass();
+        }
+    }
+
+private:
+    executor& executor_;
+    std::size_t size_;
+    std::size_t grain_;
+    std::size_t chunk_count_;
+
+    // as wide as the chunk count, a tiny grain over a huge range may not fit into 32 bits
+    alignas(hardware_destructive_interference_size) Atomic<std::size_t> remaining_{ 0 };
+    Atomic<bool> is_cancelled_{ false };
+    // the completion and the owner
+    Atomic<std::uint32_t> refs_{ 2 };
+};
+
+template <std::ranges::random_access_range RangeT, typename F, typename SlotCtorT, template <typename> typename Atomic>
+struct parallel_for_connection final : data_parallel_base<Atomic> {
+    using base_type = data_parallel_base<Atomic>;
+
+public:
+    parallel_for_connection(executor& an_executor, RangeT&& range, std::size_t grain, F&& f, SlotCtorT slot_ctor)
+        : base_type{ an_executor, static_cast<std::size_t>(std::ranges::size(range)), grain },
+          range_{ std::move(range) }, f_{ std::move(f) }, slot_{ std::move(slot_ctor)() } {}
+
+    CancelHandle auto emit() && noexcept {
+        base_type::start_pass();
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { base_type::request_cancel(); }
+
+private:
+    void process_chunk(std::size_t, std::size_t first, std::size_t last) noexcept override {
+        auto it = std::ranges::begin(range_) + first;
+        for (std::size_t i = first; i != last; ++i, ++it) {
+            f_(*it);
+        }
+    }
+
+    void finish_pass() noexcept override {
+        if (base_type::is_cancelled()) {
+            std::move(slot_).set_null();
+        } else {
+            std::move(slot_).set_value(meta::unit{});
+        }
+        base_type::release();
+    }
+
+private:
+    RangeT range_;
+    F f_;
+    SlotFrom<SlotCtorT> slot_;
+};
+
+template <
+    std::ranges::random_access_range RangeT,
+    typename T,
+    typename OpT,
+    typename SlotCtorT,
+    template <typename> typename Atomic>
+struct parallel_reduce_connection final : data_parallel_base<Atomic> {
+    using base_type = data_parallel_base<Atomic>;
+
+public:
+    parallel_reduce_connection(
+        executor& an_executor,
+        RangeT&& range,
+        std::size_t grain,
+        T&& init,
+        OpT&& op,
+        SlotCtorT slot_ctor
+    )
+        : base_type{ an_executor, static_cast<std::size_t>(std::ranges::size(range)), grain },
+          range_{ std::move(range) }, init_{ std::move(init) }, op_{ std::move(op) },
+          partials_(base_type::chunk_count()), slot_{ std::move(slot_ctor)() } {}
+
+    CancelHandle auto emit() && noexcept {
+        base_type::start_pass();
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { base_type::request_cancel(); }
+
+private:
+    void process_chunk(std::size_t index, std::size_t first, std::size_t last) noexcept override {
+        auto it = std::ranges::begin(range_) + first;
+        T partial(*it);
+        for (++it, ++first; first != last; ++it, ++first) {
+            partial = op_(std::move(partial), T(*it));
+        }
+        partials_[index].emplace(std::move(partial));
+    }
+
+    void finish_pass() noexcept override {
+        if (base_type::is_cancelled()) {
+            std::move(slot_).set_null();
+        } else {
+            T result = std::move(init_);
+            for (auto& partial : partials_) {
+                DEBUG_ASSERT(partial.has_value());
+                result = op_(std::move(result), std::move(partial).value());
+            }
+            std::move(slot_).set_value(std::move(result));
+        }
+        base_type::release();
+    }
+
+private:
+    RangeT range_;
+    T init_;
+    OpT op_;
+    std::vector<meta::maybe<T>> partials_;
+    SlotFrom<SlotCtorT> slot_;
+};
+
+// two passes: chunk totals, then each chunk is scanned w/ the combined total of the preceding ones
+template <
+    std::ranges::random_access_range InRangeT,
+    std::ranges::random_access_range OutRangeT,
+    typename OpT,
+    typename SlotCtorT,
+    template <typename> typename Atomic>
+struct parallel_inclusive_scan_connection final : data_parallel_base<Atomic> {
+    using base_type = data_parallel_base<Atomic>;
+    using value_type = std::ranges::range_value_t<InRangeT>;
+
+public:
+    parallel_inclusive_scan_connection(
+        executor& an_executor,
+        InRangeT&& in,
+        OutRangeT&& out,
+        std::size_t grain,
+        OpT&& op,
+        SlotCtorT slot_ctor
+    )
+        : base_type{ an_executor, static_cast<std::size_t>(std::ranges::size(in)), grain }, in_{ std::move(in) },
+          out_{ std::move(out) }, op_{ std::move(op) }, partials_(base_type::chunk_count()),
+          slot_{ std::move(slot_ctor)() } {
+        DEBUG_ASSERT(std::ranges::size(out_) >= std::ranges::size(in_));
+    }
+
+    CancelHandle auto emit() && noexcept {
+        base_type::start_pass();
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { base_type::request_cancel(); }
+
+private:
+    void process_chunk(std::size_t index, std::size_t first, std::size_t last) noexcept override {
+        auto in_it = std::ranges::begin(in_) + first;
+        if (!is_scanning_) {
+            value_type partial(*in_it);
+            for (++in_it, ++first; first != last; ++in_it, ++first) {
+                partial = op_(std::move(partial), value_type(*in_it));
+            }
+            partials_[index].emplace(std::move(partial));
+            return;
+        }
+
+        auto out_it = std::ranges::begin(out_) + first;
+        value_type acc = index == 0 ? value_type(*in_it) : op_(*partials_[index - 1], value_type(*in_it));
+        *out_it = acc;
+        for (++in_it, ++out_it, ++first; first != last; ++in_it, ++out_it, ++first) {
+            acc = op_(std::move(acc), value_type(*in_it));
+            *out_it = acc;
+        }
+    }
+
+    void finish_pass() noexcept override {
+        if (base_type::is_cancelled()) {
+            std::move(slot_).set_null();
+            base_type::release();
+            return;
+        }
+        if (is_scanning_ || base_type::chunk_count() == 0) {
+            std::move(slot_).set_value(meta::unit{});
+            base_type::release();
+            return;
+        }
+
+        // chunk totals become inclusive prefixes, chunk `i` starts from the prefix of `i - 1`
+        for (std::size_t i = 1; i < partials_.size(); ++i) {
+            partials_[i].emplace(op_(*partials_[i - 1], std::move(partials_[i]).value()));
+        }
+        is_scanning_ = true;
+        base_type::start_pass();
+    }
+
+private:
+    InRangeT in_;
+    OutRangeT out_;
+    OpT op_;
+    std::vector<meta::maybe<value_type>> partials_;
+    SlotFrom<SlotCtorT> slot_;
+    // flipped between the passes, the second one is started by the same thread
+    bool is_scanning_ = false;
+};
+
+template <typename ConnectionT, typename ValueT, typename... Args>
+struct [[nodiscard]] data_parallel_signal final {
+    using value_type = ValueT;
+    using error_type = meta::undefined;
+
+public:
+    explicit data_parallel_signal(executor& an_executor, Args... args)
+        : executor_{ an_executor }, args_{ std::move(args)... } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return std::apply(
+            [&](Args&&... args) {
+                return parallel_connection_box<typename ConnectionT::template type<SlotCtorT>>{
+                    executor_,
+                    std::move(args)...,
+                    std::move(slot_ctor),
+                };
+            },
+            std::move(args_)
+        );
+    }
+
+    // the result is delivered inline by whoever processes the last chunk
+    static executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    executor& executor_;
+    std::tuple<Args...> args_;
+};
+
+template <typename RangeT, typename F, template <typename> typename Atomic>
+struct parallel_for_of {
+    template <typename SlotCtorT>
+    using type = parallel_for_connection<RangeT, F, SlotCtorT, Atomic>;
+};
+
+template <typename RangeT, typename T, typename OpT, template <typename> typename Atomic>
+struct parallel_reduce_of {
+    template <typename SlotCtorT>
+    using type = parallel_reduce_connection<RangeT, T, OpT, SlotCtorT, Atomic>;
+};
+
+template <typename InRangeT, typename OutRangeT, typename OpT, template <typename> typename Atomic>
+struct parallel_inclusive_scan_of {
+    template <typename SlotCtorT>
+    using type = parallel_inclusive_scan_connection<InRangeT, OutRangeT, OpT, SlotCtorT, Atomic>;
+};
+
+} // namespace detail
+
+// `f(element)` for every element, lvalue ranges are referenced, so they have to outlive the signal
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range RangeT,
+    typename F,
+    typename ViewT = std::views::all_t<RangeT>>
+    requires std::ranges::random_access_range<ViewT> && std::ranges::sized_range<ViewT>
+constexpr Signal<meta::unit, meta::undefined> auto
+    parallel_for(executor& an_executor, RangeT&& range, std::size_t grain, F f) {
+    return detail::data_parallel_signal<detail::parallel_for_of<ViewT, F, Atomic>, meta::unit, ViewT, std::size_t, F>{
+        an_executor,
+        std::views::all(std::forward<RangeT>(range)),
+        grain,
+        std::move(f),
+    };
+}
+
+// `init` is combined w/ the chunk results once, `op(T, T) -> T` has to be associative
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range RangeT,
+    typename T,
+    typename OpT,
+    typename ViewT = std::views::all_t<RangeT>>
+    requires std::ranges::random_access_range<ViewT> && std::ranges::sized_range<ViewT>
+constexpr Signal<T, meta::undefined> auto
+    parallel_reduce(executor& an_executor, RangeT&& range, std::size_t grain, T init, OpT op) {
+    using of_type = detail::parallel_reduce_of<ViewT, T, OpT, Atomic>;
+    return detail::data_parallel_signal<of_type, T, ViewT, std::size_t, T, OpT>{
+        an_executor,
+        std::views::all(std::forward<RangeT>(range)),
+        grain,
+        std::move(init),
+        std::move(op),
+    };
+}
+
+// `out[i] = op(out[i - 1], in[i])`, `out` may be the same range as `in`, `op` has to be associative
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range InRangeT,
+    std::ranges::viewable_range OutRangeT,
+    typename OpT,
+    typename InViewT = std::views::all_t<InRangeT>,
+    typename OutViewT = std::views::all_t<OutRangeT>>
+    requires std::ranges::random_access_range<InViewT> && std::ranges::sized_range<InViewT>
+             && std::ranges::random_access_range<OutViewT> && std::ranges::sized_range<OutViewT>
+constexpr Signal<meta::unit, meta::undefined> auto parallel_inclusive_scan(
+    executor& an_executor,
+    InRangeT&& in,
+    OutRangeT&& out,
+    std::size_t grain,
+    OpT op
+) {
+    using of_type = detail::parallel_inclusive_scan_of<InViewT, OutViewT, OpT, Atomic>;
+    return detail::data_parallel_signal<of_type, meta::unit, InViewT, OutViewT, std::size_t, OpT>{
+        an_executor,
+        std::views::all(std::forward<InRangeT>(in)),
+        std::views::all(std::forward<OutRangeT>(out)),
+        grain,
+        std::move(op),
+    };
+}
+
+} // namespace sl::exec
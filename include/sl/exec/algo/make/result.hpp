@@ -5,6 +5,7 @@
 #pragma once
 
 #include "sl/exec/algo/make/as_signal.hpp"
+#include "sl/exec/model/layout.hpp"
 
 #include <sl/meta/monad/maybe.hpp>
 #include <sl/meta/monad/result.hpp>
@@ -19,7 +20,10 @@ namespace detail {
 template <typename V, typename E, typename SlotT>
 struct [[nodiscard]] result_connection final {
     meta::maybe<meta::result<V, E>> maybe_result;
-    SlotT slot;
+    [[no_unique_address]] SlotT slot;
+
+    static constexpr std::string_view layout_name = "result_connection";
+    using layout_members = std::tuple<meta::maybe<meta::result<V, E>>, SlotT>;
 
     constexpr CancelHandle auto emit() && noexcept {
         fulfill_slot(std::move(slot), std::move(maybe_result));
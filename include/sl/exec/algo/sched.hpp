@@ -5,5 +5,7 @@
 #pragma once
 
 #include "sl/exec/algo/sched/manual.hpp"
+#include "sl/exec/algo/sched/run_loop.hpp"
+#include "sl/exec/algo/sched/trampoline.hpp"
 
 #include "sl/exec/algo/sched/on.hpp"
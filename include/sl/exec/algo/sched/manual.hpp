@@ -13,6 +13,8 @@
 
 #include "sl/exec/model/executor.hpp"
 
+#include "sl/exec/thread/detail/metrics.hpp"
+
 namespace sl::exec {
 
 struct manual_executor final : executor {
@@ -20,6 +22,7 @@ struct manual_executor final : executor {
 
     void schedule(task_node& a_task_node) noexcept override;
     void stop() noexcept override;
+    constexpr std::size_t concurrency_hint() const noexcept override { return 1; }
 
     // execute finite batch of currently scheduled tasks
     std::size_t execute_batch() noexcept;
@@ -27,8 +30,15 @@ struct manual_executor final : executor {
     // less optimal then execute_batch
     std::size_t execute_at_most(std::size_t n) noexcept;
 
+    // zeroed unless built w/ SL_EXEC_METRICS
+    executor_metrics_snapshot metrics() const { return metrics_.snapshot(); }
+
+private:
+    void execute(task_node& a_task_node) noexcept;
+
 private:
     task_list task_queue_;
+    [[no_unique_address]] detail::executor_metrics<> metrics_;
 };
 
 } // namespace sl::exec
@@ -0,0 +1,93 @@
+//
+// Created by usatiynyan.
+//
+// Thread-safe counterpart of manual_executor for embedding into an existing event loop:
+// any thread can schedule, only the owning thread runs tasks.
+//
+// example of driving it from epoll:
+// ```cpp
+// run_loop_executor loop{ run_loop_config{ .with_eventfd = true } };
+// epoll_ctl(epfd, EPOLL_CTL_ADD, loop.native_handle(), &event); // EPOLLIN
+// // ... on EPOLLIN
+// loop.run_once();
+// ```
+//
+
+#pragma once
+
+#include "sl/exec/model/executor.hpp"
+
+#include "sl/exec/thread/detail/futex.hpp"
+#include "sl/exec/thread/detail/mpsc_queue.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sl::exec {
+
+struct run_loop_config {
+    // the eventfd is readable while there are tasks to run, ignored on platforms w/o eventfd
+    bool with_eventfd = false;
+};
+
+struct run_loop_executor final : executor {
+    explicit run_loop_executor(run_loop_config config = {});
+    ~run_loop_executor() noexcept override;
+
+    // any thread
+    void schedule(task_node& a_task_node) noexcept override;
+    // owner only, cancels currently scheduled tasks
+    void stop() noexcept override;
+    constexpr std::size_t concurrency_hint() const noexcept override { return 1; }
+
+    // owner only, executes tasks that were scheduled before the call, does not block
+    std::size_t run_once() noexcept;
+
+    // owner only, runs tasks and sleeps in between until predicate is satisfied, predicate is checked after every batch
+    template <typename PredicateT>
+    std::size_t run_until(PredicateT&& predicate) noexcept {
+        std::size_t counter = 0;
+        while (true) {
+            // captured before the predicate, so that a wake up in between is not lost
+            const std::uint32_t epoch = epoch_.load(std::memory_order::acquire);
+            if (predicate()) {
+                return counter;
+            }
+            const std::size_t batch_size = run_once();
+            if (batch_size == 0) {
+                wait(epoch);
+            }
+            counter += batch_size;
+        }
+    }
+
+    // owner only, runs tasks and sleeps in between until timeout has passed
+    std::size_t run_for(std::chrono::nanoseconds timeout) noexcept;
+
+    // any thread, wakes up the owner from run_until/run_for so it could re-check the predicate
+    void wake() noexcept;
+
+    // eventfd or -1
+    int native_handle() const noexcept { return event_fd_; }
+
+private:
+    task_node* pop_counted(std::uint32_t popped) noexcept;
+    void notify() noexcept;
+    void wait(std::uint32_t epoch) noexcept;
+    void wait_for(std::uint32_t epoch, std::chrono::nanoseconds timeout) noexcept;
+    void signal_eventfd() noexcept;
+    void clear_eventfd() noexcept;
+
+private:
+    detail::mpsc_queue<task_node> queue_;
+    alignas(detail::hardware_destructive_interference_size) detail::futex_word pending_{ 0 };
+    // bumped on every notification, the owner sleeps on it
+    detail::futex_word epoch_{ 0 };
+    std::atomic<bool> is_sleeping_{ false };
+    int event_fd_ = -1;
+};
+
+} // namespace sl::exec
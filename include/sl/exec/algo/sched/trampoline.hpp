@@ -0,0 +1,40 @@
+//
+// Created by usatiynyan.
+//
+// Inline executor that bounds the stack: tasks run right away until the nesting depth reaches `max_depth`,
+// deeper tasks are deferred to a thread-local queue, which the outermost `schedule` drains in FIFO order.
+// The depth and the queue are shared by all trampoline executors on the thread.
+//
+
+#pragma once
+
+#include "sl/exec/model/executor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace sl::exec {
+
+struct trampoline_executor final : executor {
+    static constexpr std::size_t default_max_depth = 64;
+
+    // at least one task has to run inline, otherwise there's no outermost frame to drain the deferred ones
+    constexpr explicit trampoline_executor(std::size_t max_depth = default_max_depth)
+        : max_depth_{ std::max<std::size_t>(max_depth, 1) } {}
+
+    void schedule(task_node& a_task_node) noexcept override;
+    // cancels the tasks deferred on the current thread
+    void stop() noexcept override;
+    constexpr std::size_t concurrency_hint() const noexcept override { return 1; }
+
+    // nesting depth of trampoline executors on the current thread
+    static std::size_t current_depth() noexcept;
+
+private:
+    std::size_t max_depth_;
+};
+
+// trampolined counterpart of `inline_executor`, w/ default_max_depth
+executor& trampoline_inline_executor();
+
+} // namespace sl::exec
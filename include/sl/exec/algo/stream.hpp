@@ -0,0 +1,16 @@
+//
+// Created by usatiynyan.
+// `map` for streams comes along with the signal one from tf.
+//
+
+#pragma once
+
+#include "sl/exec/algo/stream/source.hpp"
+
+#include "sl/exec/algo/stream/batch.hpp"
+#include "sl/exec/algo/stream/filter.hpp"
+#include "sl/exec/algo/stream/map.hpp"
+#include "sl/exec/algo/stream/merge.hpp"
+#include "sl/exec/algo/stream/take.hpp"
+
+#include "sl/exec/algo/stream/sink.hpp"
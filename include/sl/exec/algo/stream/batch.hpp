@@ -0,0 +1,116 @@
+//
+// Created by usatiynyan.
+// `stream | batch(n)` - values are grouped into vectors of n, the last one may be shorter, `batch(0)` is `batch(1)`.
+// A request for k batches is a request for k * n values.
+//
+
+#pragma once
+
+#include "sl/exec/model/stream.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+template <SomeStream StreamT, typename SlotCtorT>
+struct [[nodiscard]] batch_stream_connection final {
+    using element_value_type = typename StreamT::value_type;
+    using value_type = std::vector<element_value_type>;
+    using error_type = typename StreamT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+    struct batch_stream_slot final {
+        batch_stream_connection& self;
+        slot_type slot;
+
+        void set_next(element_value_type&& value) noexcept {
+            self.buffer_.push_back(std::move(value));
+            if (self.buffer_.size() == self.size_) {
+                slot.set_next(self.take_buffer());
+            }
+        }
+        void set_value(meta::unit&& value) && noexcept {
+            if (!self.buffer_.empty()) {
+                slot.set_next(self.take_buffer());
+            }
+            std::move(slot).set_value(std::move(value));
+        }
+        void set_error(error_type&& error) && noexcept { std::move(slot).set_error(std::move(error)); }
+        void set_null() && noexcept { std::move(slot).set_null(); }
+    };
+
+    struct batch_stream_slot_ctor final {
+        batch_stream_connection& self;
+        SlotCtorT slot_ctor;
+
+        constexpr batch_stream_slot operator()() && noexcept {
+            return batch_stream_slot{ .self = self, .slot = std::move(slot_ctor)() };
+        }
+    };
+
+public:
+    batch_stream_connection(StreamT&& stream, std::size_t size, SlotCtorT&& slot_ctor)
+        // zero would never request anything, so is treated as one
+        : size_{ std::max<std::size_t>(size, 1) },
+          connection_{ std::move(stream).subscribe(batch_stream_slot_ctor{ *this, std::move(slot_ctor) }) } {
+        buffer_.reserve(size_);
+    }
+
+    void emit() noexcept { connection_.emit(); }
+    void request(std::size_t n) noexcept { connection_.request(n * size_); }
+    void try_cancel() noexcept { connection_.try_cancel(); }
+
+private:
+    value_type take_buffer() noexcept {
+        value_type batch = std::exchange(buffer_, value_type{});
+        buffer_.reserve(size_);
+        return batch;
+    }
+
+private:
+    std::size_t size_;
+    value_type buffer_{};
+    StreamConnectionFor<StreamT, batch_stream_slot_ctor> connection_;
+};
+
+template <SomeStream StreamT>
+struct [[nodiscard]] batch_stream final {
+    using value_type = std::vector<typename StreamT::value_type>;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr batch_stream(StreamT&& stream, std::size_t size) : stream_{ std::move(stream) }, size_{ size } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return batch_stream_connection<StreamT, SlotCtorT>{ std::move(stream_), size_, std::move(slot_ctor) };
+    }
+
+    constexpr executor& get_executor() noexcept { return stream_.get_executor(); }
+
+private:
+    StreamT stream_;
+    std::size_t size_;
+};
+
+struct [[nodiscard]] batch final {
+    constexpr explicit batch(std::size_t size) : size_{ size } {}
+
+    template <SomeStream StreamT>
+    constexpr SomeStream auto operator()(StreamT&& stream) && noexcept {
+        return batch_stream<StreamT>{ std::move(stream), size_ };
+    }
+
+private:
+    std::size_t size_;
+};
+
+} // namespace detail
+
+constexpr auto batch(std::size_t size) noexcept { return detail::batch{ size }; }
+
+} // namespace sl::exec
@@ -0,0 +1,132 @@
+//
+// Created by usatiynyan.
+// Common driver of stream sources: requests, cancellation and asynchronous completions are turned into events,
+// and whoever makes the event count non-zero drains them, so `set_next()` calls are never concurrent or nested.
+// The count shares the state word w/ the cancellation and finish flags: the drainer lets go of the events and marks
+// the source finished in a single CAS, then delivers the terminal, so later events don't touch the source.
+//
+
+#pragma once
+
+#include "sl/exec/model/stream.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/monad/result.hpp>
+#include <sl/meta/type/unit.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sl::exec::detail {
+
+// `DerivedT::pump()` is called by the drainer once per batch of events, it may `next()` while `demand()` allows
+// and `finish()` at most once
+template <typename DerivedT, typename ValueT, typename ErrorT, typename SlotT, template <typename> typename Atomic>
+struct stream_pump {
+    using value_type = ValueT;
+    using error_type = ErrorT;
+    using result_type = meta::result<meta::unit, error_type>;
+
+public:
+    explicit stream_pump(SlotT&& slot) : slot_{ std::move(slot) } {}
+
+    stream_pump(const stream_pump&) = delete;
+    stream_pump& operator=(const stream_pump&) = delete;
+
+public: // connection
+    void request(std::size_t n) noexcept {
+        requested_.fetch_add(n, std::memory_order::relaxed);
+        notify();
+    }
+    // the request and the event are a single RMW, so that it can't outrun a terminal that's being delivered
+    void try_cancel() noexcept { notify(cancel_requested); }
+
+protected:
+    // an event for the drainer, e.g. an asynchronous completion, dropped once the source has finished
+    void notify(std::uint32_t flags = 0) noexcept {
+        std::uint32_t state = state_.load(std::memory_order::relaxed);
+        do {
+            if (state & finished) {
+                return;
+            }
+        } while (!state_.compare_exchange_weak(
+            state, (state | flags) + 1, std::memory_order::acq_rel, std::memory_order::relaxed
+        ));
+        if ((state & event_mask) == 0) {
+            drain();
+        }
+    }
+
+    [[nodiscard]] std::size_t demand() const noexcept { return demand_; }
+    [[nodiscard]] bool is_cancel_requested() const noexcept {
+        return state_.load(std::memory_order::relaxed) & cancel_requested;
+    }
+    [[nodiscard]] bool is_finished() const noexcept { return maybe_terminal_.has_value(); }
+
+    void next(value_type&& value) noexcept {
+        DEBUG_ASSERT(demand_ > 0 && !is_finished());
+        --demand_;
+        slot_.set_next(std::move(value));
+        // requests made from within set_next are picked up right away
+        demand_ += requested_.exchange(0, std::memory_order::acq_rel);
+    }
+
+    void finish(meta::maybe<result_type> maybe_result) noexcept {
+        DEBUG_ASSERT(!is_finished());
+        maybe_terminal_.emplace(std::move(maybe_result));
+    }
+
+private:
+    void drain() noexcept {
+        std::uint32_t count = 1;
+        meta::maybe<meta::maybe<result_type>> maybe_terminal;
+        while (true) {
+            demand_ += requested_.exchange(0, std::memory_order::acq_rel);
+            if (!is_finished()) {
+                static_cast<DerivedT&>(*this).pump();
+                if (is_finished()) {
+                    maybe_terminal.emplace(std::move(*maybe_terminal_));
+                }
+            }
+
+            std::uint32_t state = state_.load(std::memory_order::relaxed);
+            std::uint32_t next_state = 0;
+            do {
+                next_state = state - count;
+                if ((next_state & event_mask) == 0 && maybe_terminal.has_value()) {
+                    next_state |= finished;
+                }
+            } while (!state_.compare_exchange_weak(
+                state, next_state, std::memory_order::acq_rel, std::memory_order::relaxed
+            ));
+            count = next_state & event_mask;
+            if (count == 0) {
+                break;
+            }
+        }
+
+        // last, since the consumer may destroy the source right away
+        if (maybe_terminal.has_value()) {
+            fulfill_slot(std::move(slot_), std::move(maybe_terminal).value());
+        }
+    }
+
+private:
+    static constexpr std::uint32_t finished = std::uint32_t{ 1 } << 31;
+    static constexpr std::uint32_t cancel_requested = std::uint32_t{ 1 } << 30;
+    static constexpr std::uint32_t event_mask = cancel_requested - 1;
+
+    SlotT slot_;
+    // drainer state, synchronized via `state_`
+    std::size_t demand_ = 0;
+    meta::maybe<meta::maybe<result_type>> maybe_terminal_{};
+
+    // event count | cancel_requested | finished
+    Atomic<std::uint32_t> state_{ 0 };
+    Atomic<std::size_t> requested_{ 0 };
+};
+
+} // namespace sl::exec::detail
@@ -0,0 +1,113 @@
+//
+// Created by usatiynyan.
+// `stream | filter(predicate)` - values that don't satisfy the predicate are dropped,
+// each drop is a request for one more.
+//
+
+#pragma once
+
+#include "sl/exec/model/stream.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <SomeStream StreamT, typename PredicateT, typename SlotCtorT>
+struct [[nodiscard]] filter_stream_connection final {
+    using value_type = typename StreamT::value_type;
+    using error_type = typename StreamT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+    struct filter_stream_slot final {
+        filter_stream_connection& self;
+        PredicateT predicate;
+        slot_type slot;
+
+        void set_next(value_type&& value) noexcept {
+            if (predicate(std::as_const(value))) {
+                slot.set_next(std::move(value));
+            } else {
+                self.connection_.request(1);
+            }
+        }
+        void set_value(meta::unit&& value) && noexcept { std::move(slot).set_value(std::move(value)); }
+        void set_error(error_type&& error) && noexcept { std::move(slot).set_error(std::move(error)); }
+        void set_null() && noexcept { std::move(slot).set_null(); }
+    };
+
+    struct filter_stream_slot_ctor final {
+        filter_stream_connection& self;
+        PredicateT predicate;
+        SlotCtorT slot_ctor;
+
+        constexpr filter_stream_slot operator()() && noexcept {
+            return filter_stream_slot{
+                .self = self,
+                .predicate = std::move(predicate),
+                .slot = std::move(slot_ctor)(),
+            };
+        }
+    };
+
+public:
+    filter_stream_connection(StreamT&& stream, PredicateT&& predicate, SlotCtorT&& slot_ctor)
+        : connection_{ std::move(stream).subscribe(
+              filter_stream_slot_ctor{ *this, std::move(predicate), std::move(slot_ctor) }
+          ) } {}
+
+    void emit() noexcept { connection_.emit(); }
+    void request(std::size_t n) noexcept { connection_.request(n); }
+    void try_cancel() noexcept { connection_.try_cancel(); }
+
+private:
+    StreamConnectionFor<StreamT, filter_stream_slot_ctor> connection_;
+};
+
+template <SomeStream StreamT, typename PredicateT>
+struct [[nodiscard]] filter_stream final {
+    using value_type = typename StreamT::value_type;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr filter_stream(StreamT&& stream, PredicateT&& predicate)
+        : stream_{ std::move(stream) }, predicate_{ std::move(predicate) } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return filter_stream_connection<StreamT, PredicateT, SlotCtorT>{
+            std::move(stream_),
+            std::move(predicate_),
+            std::move(slot_ctor),
+        };
+    }
+
+    constexpr executor& get_executor() noexcept { return stream_.get_executor(); }
+
+private:
+    StreamT stream_;
+    PredicateT predicate_;
+};
+
+template <typename PredicateT>
+struct [[nodiscard]] filter final {
+    constexpr explicit filter(PredicateT&& predicate) : predicate_{ std::move(predicate) } {}
+
+    template <SomeStream StreamT>
+    constexpr SomeStream auto operator()(StreamT&& stream) && noexcept {
+        return filter_stream<StreamT, PredicateT>{ std::move(stream), std::move(predicate_) };
+    }
+
+private:
+    PredicateT predicate_;
+};
+
+} // namespace detail
+
+template <typename PredicateT>
+constexpr auto filter(PredicateT predicate) noexcept {
+    return detail::filter<PredicateT>{ std::move(predicate) };
+}
+
+} // namespace sl::exec
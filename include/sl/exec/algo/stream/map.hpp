@@ -0,0 +1,81 @@
+//
+// Created by usatiynyan.
+// `stream | map(f)` - every value is transformed inline, on the thread that produced it.
+//
+
+#pragma once
+
+#include "sl/exec/model/stream.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sl::exec::detail {
+
+template <SomeStream StreamT, typename F, typename SlotCtorT>
+struct [[nodiscard]] map_stream_connection final {
+    using input_value_type = typename StreamT::value_type;
+    using value_type = std::invoke_result_t<F&, input_value_type>;
+    using error_type = typename StreamT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+    struct map_stream_slot final {
+        F functor;
+        slot_type slot;
+
+        void set_next(input_value_type&& value) noexcept { slot.set_next(functor(std::move(value))); }
+        void set_value(meta::unit&& value) && noexcept { std::move(slot).set_value(std::move(value)); }
+        void set_error(error_type&& error) && noexcept { std::move(slot).set_error(std::move(error)); }
+        void set_null() && noexcept { std::move(slot).set_null(); }
+    };
+
+    struct map_stream_slot_ctor final {
+        F functor;
+        SlotCtorT slot_ctor;
+
+        constexpr map_stream_slot operator()() && noexcept {
+            return map_stream_slot{ .functor = std::move(functor), .slot = std::move(slot_ctor)() };
+        }
+    };
+
+public:
+    map_stream_connection(StreamT&& stream, F&& functor, SlotCtorT&& slot_ctor)
+        : connection_{
+              std::move(stream).subscribe(map_stream_slot_ctor{ std::move(functor), std::move(slot_ctor) }),
+          } {}
+
+    void emit() noexcept { connection_.emit(); }
+    void request(std::size_t n) noexcept { connection_.request(n); }
+    void try_cancel() noexcept { connection_.try_cancel(); }
+
+private:
+    StreamConnectionFor<StreamT, map_stream_slot_ctor> connection_;
+};
+
+template <SomeStream StreamT, typename F>
+struct [[nodiscard]] map_stream final {
+    using value_type = std::invoke_result_t<F&, typename StreamT::value_type>;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr map_stream(StreamT&& stream, F&& functor)
+        : stream_{ std::move(stream) }, functor_{ std::move(functor) } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return map_stream_connection<StreamT, F, SlotCtorT>{
+            std::move(stream_),
+            std::move(functor_),
+            std::move(slot_ctor),
+        };
+    }
+
+    constexpr executor& get_executor() noexcept { return stream_.get_executor(); }
+
+private:
+    StreamT stream_;
+    F functor_;
+};
+
+} // namespace sl::exec::detail
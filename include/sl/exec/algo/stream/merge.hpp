@@ -0,0 +1,239 @@
+//
+// Created by usatiynyan.
+// `merge(streams...)` - values of all the streams in the order they come, ends once all of them have ended.
+// The demand is spread round-robin with at most one outstanding value per stream,
+// the first error or null cancels the rest and is delivered after all of them have ended.
+//
+
+#pragma once
+
+#include "sl/exec/algo/stream/detail/pump.hpp"
+#include "sl/exec/model/stream.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/func/lazy_eval.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/type/pack.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <
+    typename ValueT,
+    typename ErrorT,
+    template <typename> typename Atomic,
+    typename SlotCtorT,
+    SomeStream... StreamTs>
+struct [[nodiscard]] merge_stream_connection final
+    : stream_pump<
+          merge_stream_connection<ValueT, ErrorT, Atomic, SlotCtorT, StreamTs...>,
+          ValueT,
+          ErrorT,
+          SlotFrom<SlotCtorT>,
+          Atomic> {
+    using base_type = stream_pump<merge_stream_connection, ValueT, ErrorT, SlotFrom<SlotCtorT>, Atomic>;
+    using result_type = typename base_type::result_type;
+    friend base_type;
+
+private:
+    static constexpr std::size_t N = sizeof...(StreamTs);
+    static_assert(N <= 64, "readiness of the streams is a bitmask");
+
+    template <std::size_t Index>
+    struct merge_slot final {
+        merge_stream_connection& self;
+
+        void set_next(ValueT&& value) noexcept {
+            self.maybe_values_[Index].emplace(std::move(value));
+            self.make_ready(self.values_ready_, Index);
+        }
+        void set_value(meta::unit&& value) && noexcept {
+            self.maybe_terminals_[Index].emplace(result_type{ meta::ok_tag, std::move(value) });
+            self.make_ready(self.terminals_ready_, Index);
+        }
+        void set_error(ErrorT&& error) && noexcept {
+            self.maybe_terminals_[Index].emplace(result_type{ meta::err_tag, std::move(error) });
+            self.make_ready(self.terminals_ready_, Index);
+        }
+        void set_null() && noexcept {
+            self.maybe_terminals_[Index].emplace(meta::null);
+            self.make_ready(self.terminals_ready_, Index);
+        }
+    };
+
+    template <std::size_t Index>
+    struct merge_slot_ctor final {
+        merge_stream_connection& self;
+
+        constexpr merge_slot<Index> operator()() && noexcept { return merge_slot<Index>{ self }; }
+    };
+
+    template <std::size_t Index>
+    using connection_type = StreamConnectionFor<meta::type::at_t<Index, StreamTs...>, merge_slot_ctor<Index>>;
+
+    template <std::size_t... Indexes>
+    static auto derive_connections_type(std::index_sequence<Indexes...>) -> std::tuple<connection_type<Indexes>...>;
+    using connections_type = decltype(derive_connections_type(std::make_index_sequence<N>()));
+
+    template <std::size_t... Indexes>
+    static auto make_connections(
+        merge_stream_connection& self,
+        std::tuple<StreamTs...>&& streams,
+        std::index_sequence<Indexes...>
+    ) {
+        return std::make_tuple(meta::lazy_eval{ [stream = std::move(std::get<Indexes>(streams)), &self]() mutable {
+            return std::move(stream).subscribe(merge_slot_ctor<Indexes>{ self });
+        } }...);
+    }
+
+public:
+    merge_stream_connection(std::tuple<StreamTs...>&& streams, SlotCtorT&& slot_ctor)
+        : base_type{ std::move(slot_ctor)() },
+          connections_{ make_connections(*this, std::move(streams), std::make_index_sequence<N>()) } {}
+
+public: // connection
+    void emit() noexcept {
+        std::apply([](auto&... connections) { (connections.emit(), ...); }, connections_);
+    }
+
+private:
+    void make_ready(Atomic<std::uint64_t>& ready, std::size_t index) noexcept {
+        ready.fetch_or(std::uint64_t{ 1 } << index, std::memory_order::release);
+        this->notify();
+    }
+
+    template <typename F>
+    void visit(std::size_t index, F&& f) noexcept {
+        [&]<std::size_t... Indexes>(std::index_sequence<Indexes...>) {
+            ((index == Indexes ? f(std::get<Indexes>(connections_)) : void()), ...);
+        }(std::make_index_sequence<N>());
+    }
+
+    void cancel_pending() noexcept {
+        for (std::size_t i = 0; i != N; ++i) {
+            if (!inputs_[i].is_ended) {
+                visit(i, [](auto& connection) { connection.try_cancel(); });
+            }
+        }
+    }
+
+    void pump() noexcept {
+        // a stream's value is published before its terminal, so terminals go first not to outrun the values
+        const std::uint64_t terminals_ready = terminals_ready_.exchange(0, std::memory_order::acquire);
+        const std::uint64_t values_ready = values_ready_.exchange(0, std::memory_order::acquire);
+        for (std::size_t i = 0; i != N; ++i) {
+            const std::uint64_t bit = std::uint64_t{ 1 } << i;
+            if (values_ready & bit) {
+                inputs_[i].is_requested = false;
+                ValueT value = std::move(maybe_values_[i]).value();
+                maybe_values_[i].reset();
+                this->next(std::move(value));
+            }
+            if (terminals_ready & bit) {
+                inputs_[i].is_requested = false;
+                meta::maybe<result_type> maybe_result = std::move(maybe_terminals_[i]).value();
+                inputs_[i].is_ended = true;
+                ++ended_count_;
+                const bool is_failure = !maybe_result.has_value() || !maybe_result->has_value();
+                if (is_failure && !maybe_failure_.has_value()) {
+                    maybe_failure_.emplace(std::move(maybe_result));
+                    is_cancelling_ = true;
+                    cancel_pending();
+                }
+            }
+        }
+
+        if (this->is_cancel_requested() && !std::exchange(is_cancelling_, true)) {
+            maybe_failure_.emplace(meta::null);
+            cancel_pending();
+        }
+
+        if (ended_count_ == N) {
+            if (maybe_failure_.has_value()) {
+                this->finish(std::move(maybe_failure_).value());
+            } else {
+                this->finish(result_type{ meta::ok_tag, meta::unit{} });
+            }
+            return;
+        }
+        if (is_cancelling_) {
+            return;
+        }
+
+        std::size_t requested_count = 0;
+        for (const input& an_input : inputs_) {
+            requested_count += an_input.is_requested ? 1 : 0;
+        }
+        // may be delivered inline, then it's picked up by the next round of this very drainer
+        for (std::size_t step = 0; step != N && this->demand() > requested_count; ++step) {
+            const std::size_t i = std::exchange(next_input_, (next_input_ + 1) % N);
+            if (inputs_[i].is_ended || inputs_[i].is_requested) {
+                continue;
+            }
+            inputs_[i].is_requested = true;
+            ++requested_count;
+            visit(i, [](auto& connection) { connection.request(1); });
+        }
+    }
+
+private:
+    struct input {
+        bool is_requested = false;
+        bool is_ended = false;
+    };
+
+    connections_type connections_;
+    // written by the streams, read by the drainer after the corresponding bit
+    std::array<meta::maybe<ValueT>, N> maybe_values_{};
+    std::array<meta::maybe<meta::maybe<result_type>>, N> maybe_terminals_{};
+    Atomic<std::uint64_t> values_ready_{ 0 };
+    Atomic<std::uint64_t> terminals_ready_{ 0 };
+    // drainer state
+    std::array<input, N> inputs_{};
+    std::size_t ended_count_ = 0;
+    std::size_t next_input_ = 0;
+    bool is_cancelling_ = false;
+    meta::maybe<meta::maybe<result_type>> maybe_failure_{};
+};
+
+template <template <typename> typename Atomic, SomeStream StreamT, SomeStream... StreamTs>
+struct [[nodiscard]] merge_stream final {
+    using value_type = typename StreamT::value_type;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr explicit merge_stream(StreamT&& stream, StreamTs&&... streams)
+        : streams_{ std::move(stream), std::move(streams)... } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return merge_stream_connection<value_type, error_type, Atomic, SlotCtorT, StreamT, StreamTs...>{
+            std::move(streams_),
+            std::move(slot_ctor),
+        };
+    }
+
+    // values are delivered inline by the stream that produced them
+    static executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    std::tuple<StreamT, StreamTs...> streams_;
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic, SomeStream StreamT, SomeStream... StreamTs>
+    requires(std::same_as<typename StreamT::value_type, typename StreamTs::value_type> && ...)
+            && (std::same_as<typename StreamT::error_type, typename StreamTs::error_type> && ...)
+constexpr SomeStream auto merge(StreamT stream, StreamTs... streams) {
+    return detail::merge_stream<Atomic, StreamT, StreamTs...>{ std::move(stream), std::move(streams)... };
+}
+
+} // namespace sl::exec
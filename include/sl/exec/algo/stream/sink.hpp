@@ -0,0 +1,134 @@
+//
+// Created by usatiynyan.
+// Ends of stream pipelines, they turn a stream back into a signal:
+//  - `stream | for_each(f)` - `f(value)` for every value, completes with unit
+//  - `stream | collect()` - gathers all the values into a vector
+// Values are requested one by one, each after the previous one is handled.
+// `try_cancel()` is forwarded to the stream.
+//
+
+#pragma once
+
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/stream.hpp"
+
+#include <sl/meta/type/unit.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+// `Collect` gathers the values instead of calling `F`
+template <SomeStream StreamT, typename F, bool Collect, typename SlotCtorT>
+struct [[nodiscard]] for_each_connection final {
+    using element_value_type = typename StreamT::value_type;
+    using value_type = std::conditional_t<Collect, std::vector<element_value_type>, meta::unit>;
+    using error_type = typename StreamT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+    struct for_each_slot final {
+        for_each_connection& self;
+
+        void set_next(element_value_type&& value) noexcept {
+            if constexpr (Collect) {
+                self.values_.push_back(std::move(value));
+            } else {
+                self.functor_(std::move(value));
+            }
+            self.connection_.request(1);
+        }
+        void set_value(meta::unit&& value) && noexcept {
+            if constexpr (Collect) {
+                std::move(self.slot_).set_value(std::move(self.values_));
+            } else {
+                std::move(self.slot_).set_value(std::move(value));
+            }
+        }
+        void set_error(error_type&& error) && noexcept { std::move(self.slot_).set_error(std::move(error)); }
+        void set_null() && noexcept { std::move(self.slot_).set_null(); }
+    };
+
+    struct for_each_slot_ctor final {
+        for_each_connection& self;
+
+        constexpr for_each_slot operator()() && noexcept { return for_each_slot{ self }; }
+    };
+
+public:
+    for_each_connection(StreamT&& stream, F&& functor, SlotCtorT&& slot_ctor)
+        : functor_{ std::move(functor) }, slot_{ std::move(slot_ctor)() },
+          connection_{ std::move(stream).subscribe(for_each_slot_ctor{ *this }) } {}
+
+    CancelHandle auto emit() && noexcept {
+        connection_.emit();
+        // the stream may end right away, so `this` is not touched afterwards
+        connection_.request(1);
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { connection_.try_cancel(); }
+
+private:
+    F functor_;
+    slot_type slot_;
+    value_type values_{};
+    StreamConnectionFor<StreamT, for_each_slot_ctor> connection_;
+};
+
+template <SomeStream StreamT, typename F, bool Collect>
+struct [[nodiscard]] for_each_signal final {
+    using value_type = std::conditional_t<Collect, std::vector<typename StreamT::value_type>, meta::unit>;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr for_each_signal(StreamT&& stream, F&& functor)
+        : stream_{ std::move(stream) }, functor_{ std::move(functor) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return for_each_connection<StreamT, F, Collect, SlotCtorT>{
+            std::move(stream_),
+            std::move(functor_),
+            std::move(slot_ctor),
+        };
+    }
+
+    constexpr executor& get_executor() noexcept { return stream_.get_executor(); }
+
+private:
+    StreamT stream_;
+    F functor_;
+};
+
+template <typename F>
+struct [[nodiscard]] for_each final {
+    constexpr explicit for_each(F&& functor) : functor_{ std::move(functor) } {}
+
+    template <SomeStream StreamT>
+    constexpr SomeSignal auto operator()(StreamT&& stream) && noexcept {
+        return for_each_signal<StreamT, F, /*Collect=*/false>{ std::move(stream), std::move(functor_) };
+    }
+
+private:
+    F functor_;
+};
+
+struct [[nodiscard]] collect final {
+    template <SomeStream StreamT>
+    constexpr SomeSignal auto operator()(StreamT&& stream) && noexcept {
+        return for_each_signal<StreamT, meta::unit, /*Collect=*/true>{ std::move(stream), meta::unit{} };
+    }
+};
+
+} // namespace detail
+
+template <typename F>
+constexpr auto for_each(F functor) noexcept {
+    return detail::for_each<F>{ std::move(functor) };
+}
+
+constexpr auto collect() noexcept { return detail::collect{}; }
+
+} // namespace sl::exec
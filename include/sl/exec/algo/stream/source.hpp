@@ -0,0 +1,225 @@
+//
+// Created by usatiynyan.
+// Beginnings of stream pipelines:
+//  - `as_stream(range)` - elements of a range, lvalue ranges are referenced, so they have to outlive the stream
+//  - `as_stream(channel)` - values received from a channel until it's closed, one receive per requested value
+//
+
+#pragma once
+
+#include "sl/exec/algo/stream/detail/pump.hpp"
+#include "sl/exec/algo/sync/channel.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/stream.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/func/lazy_eval.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/type/undefined.hpp>
+#include <sl/meta/type/unit.hpp>
+
+#include <ranges>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <std::ranges::input_range ViewT, typename SlotCtorT, template <typename> typename Atomic>
+struct [[nodiscard]] range_stream_connection final
+    : stream_pump<
+          range_stream_connection<ViewT, SlotCtorT, Atomic>,
+          std::ranges::range_value_t<ViewT>,
+          meta::undefined,
+          SlotFrom<SlotCtorT>,
+          Atomic> {
+    using base_type = stream_pump<
+        range_stream_connection,
+        std::ranges::range_value_t<ViewT>,
+        meta::undefined,
+        SlotFrom<SlotCtorT>,
+        Atomic>;
+    using value_type = typename base_type::value_type;
+    using result_type = typename base_type::result_type;
+    friend base_type;
+
+public:
+    range_stream_connection(ViewT&& view, SlotCtorT&& slot_ctor)
+        : base_type{ std::move(slot_ctor)() }, view_{ std::move(view) }, it_{ std::ranges::begin(view_) } {}
+
+public: // connection
+    void emit() noexcept {}
+
+private:
+    void pump() noexcept {
+        while (this->demand() > 0 && it_ != std::ranges::end(view_) && !this->is_cancel_requested()) {
+            value_type value(*it_);
+            ++it_;
+            this->next(std::move(value));
+        }
+
+        if (this->is_cancel_requested()) {
+            this->finish(meta::null);
+        } else if (it_ == std::ranges::end(view_) && this->demand() > 0) {
+            this->finish(result_type{ meta::ok_tag, meta::unit{} });
+        }
+    }
+
+private:
+    ViewT view_;
+    std::ranges::iterator_t<ViewT> it_;
+};
+
+template <std::ranges::input_range ViewT, template <typename> typename Atomic>
+struct [[nodiscard]] range_stream final {
+    using value_type = std::ranges::range_value_t<ViewT>;
+    using error_type = meta::undefined;
+
+public:
+    constexpr explicit range_stream(ViewT&& view) : view_{ std::move(view) } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return range_stream_connection<ViewT, SlotCtorT, Atomic>{ std::move(view_), std::move(slot_ctor) };
+    }
+
+    static executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    ViewT view_;
+};
+
+template <typename V, typename Mutex, template <typename> typename Atomic, typename SlotCtorT>
+struct [[nodiscard]] channel_stream_connection final
+    : stream_pump<
+          channel_stream_connection<V, Mutex, Atomic, SlotCtorT>,
+          V,
+          meta::undefined,
+          SlotFrom<SlotCtorT>,
+          Atomic> {
+    using base_type = stream_pump<channel_stream_connection, V, meta::undefined, SlotFrom<SlotCtorT>, Atomic>;
+    using result_type = typename base_type::result_type;
+    using receive_result_type = meta::result<V, meta::unit>;
+    friend base_type;
+
+private:
+    struct receive_slot final {
+        channel_stream_connection& self;
+
+        void set_value(V&& value) && noexcept {
+            self.complete_receive(receive_result_type{ meta::ok_tag, std::move(value) });
+        }
+        void set_error(meta::unit&& error) && noexcept {
+            self.complete_receive(receive_result_type{ meta::err_tag, std::move(error) });
+        }
+        void set_null() && noexcept { self.complete_receive(meta::null); }
+    };
+
+    struct receive_slot_ctor final {
+        channel_stream_connection& self;
+
+        constexpr receive_slot operator()() && noexcept { return receive_slot{ self }; }
+    };
+
+    using receive_connection_type = ConnectionFor<channel_receive_signal<V, Mutex, Atomic>, receive_slot_ctor>;
+    using receive_cancel_handle_type = decltype(std::declval<receive_connection_type&&>().emit());
+
+public:
+    channel_stream_connection(channel<V, Mutex, Atomic>& a_channel, SlotCtorT&& slot_ctor)
+        : base_type{ std::move(slot_ctor)() }, channel_{ a_channel } {}
+
+public: // connection
+    void emit() noexcept {}
+
+private:
+    void complete_receive(meta::maybe<receive_result_type> maybe_result) noexcept {
+        maybe_received_.emplace(std::move(maybe_result));
+        is_received_.store(true, std::memory_order::release);
+        this->notify();
+    }
+
+    void pump() noexcept {
+        if (is_received_.exchange(false, std::memory_order::acquire)) {
+            meta::maybe<receive_result_type> maybe_result = std::move(maybe_received_).value();
+            maybe_received_.reset();
+            receive_cancel_handle_.reset();
+            receive_connection_.reset();
+
+            if (!maybe_result.has_value()) {
+                this->finish(meta::null);
+                return;
+            }
+            receive_result_type result = std::move(maybe_result).value();
+            if (!result.has_value()) {
+                // closed
+                this->finish(result_type{ meta::ok_tag, meta::unit{} });
+                return;
+            }
+            this->next(std::move(result).value());
+        }
+
+        if (receive_connection_.has_value()) {
+            if (this->is_cancel_requested() && !std::exchange(is_receive_cancelled_, true)) {
+                std::move(*receive_cancel_handle_).try_cancel();
+            }
+            return;
+        }
+        if (this->is_cancel_requested()) {
+            this->finish(meta::null);
+            return;
+        }
+        if (this->demand() > 0) {
+            // may complete inline, then it's picked up by the next round of this very drainer
+            auto& connection = receive_connection_.emplace(
+                meta::lazy_eval{ [&] { return channel_.receive().subscribe(receive_slot_ctor{ *this }); } }
+            );
+            receive_cancel_handle_.emplace(std::move(connection).emit());
+        }
+    }
+
+private:
+    channel<V, Mutex, Atomic>& channel_;
+    // drainer state
+    meta::maybe<receive_connection_type> receive_connection_{};
+    meta::maybe<receive_cancel_handle_type> receive_cancel_handle_{};
+    bool is_receive_cancelled_ = false;
+    // written by the receive, read by the drainer
+    meta::maybe<meta::maybe<receive_result_type>> maybe_received_{};
+    Atomic<bool> is_received_{ false };
+};
+
+template <typename V, typename Mutex, template <typename> typename Atomic>
+struct [[nodiscard]] channel_stream final {
+    using value_type = V;
+    using error_type = meta::undefined;
+
+public:
+    constexpr explicit channel_stream(channel<V, Mutex, Atomic>& a_channel) : channel_{ a_channel } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return channel_stream_connection<V, Mutex, Atomic, SlotCtorT>{ channel_, std::move(slot_ctor) };
+    }
+
+    static executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    channel<V, Mutex, Atomic>& channel_;
+};
+
+} // namespace detail
+
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range RangeT,
+    typename ViewT = std::views::all_t<RangeT>>
+    requires std::ranges::input_range<ViewT>
+constexpr SomeStream auto as_stream(RangeT&& range) {
+    return detail::range_stream<ViewT, Atomic>{ std::views::all(std::forward<RangeT>(range)) };
+}
+
+template <typename V, typename Mutex, template <typename> typename Atomic>
+constexpr SomeStream auto as_stream(channel<V, Mutex, Atomic>& a_channel) {
+    return detail::channel_stream<V, Mutex, Atomic>{ a_channel };
+}
+
+} // namespace sl::exec
@@ -0,0 +1,121 @@
+//
+// Created by usatiynyan.
+// `stream | take(n)` - at most n values, then the stream is cancelled and ends with `set_value`.
+// The cancellation is issued right after the n-th value, w/o waiting for the consumer to request past it.
+//
+
+#pragma once
+
+#include "sl/exec/model/stream.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <SomeStream StreamT, typename SlotCtorT>
+struct [[nodiscard]] take_stream_connection final {
+    using value_type = typename StreamT::value_type;
+    using error_type = typename StreamT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+    struct take_stream_slot final {
+        take_stream_connection& self;
+        slot_type slot;
+
+        void set_next(value_type&& value) noexcept {
+            // the consumer may request from within, so the count goes first
+            const bool is_last = --self.to_deliver_ == 0;
+            slot.set_next(std::move(value));
+            // the terminal is deferred by the stream until this returns
+            if (is_last) {
+                self.connection_.try_cancel();
+            }
+        }
+        void set_value(meta::unit&& value) && noexcept { std::move(slot).set_value(std::move(value)); }
+        void set_error(error_type&& error) && noexcept { std::move(slot).set_error(std::move(error)); }
+        void set_null() && noexcept {
+            if (self.to_deliver_ == 0) {
+                std::move(slot).set_value(meta::unit{});
+            } else {
+                std::move(slot).set_null();
+            }
+        }
+    };
+
+    struct take_stream_slot_ctor final {
+        take_stream_connection& self;
+        SlotCtorT slot_ctor;
+
+        constexpr take_stream_slot operator()() && noexcept {
+            return take_stream_slot{ .self = self, .slot = std::move(slot_ctor)() };
+        }
+    };
+
+public:
+    take_stream_connection(StreamT&& stream, std::size_t count, SlotCtorT&& slot_ctor)
+        : to_request_{ count }, to_deliver_{ count },
+          connection_{ std::move(stream).subscribe(take_stream_slot_ctor{ *this, std::move(slot_ctor) }) } {}
+
+    void emit() noexcept {
+        connection_.emit();
+        if (to_deliver_ == 0) {
+            connection_.try_cancel();
+        }
+    }
+    void request(std::size_t n) noexcept {
+        const std::size_t allowed = std::min(n, to_request_);
+        to_request_ -= allowed;
+        if (allowed != 0) {
+            connection_.request(allowed);
+        }
+    }
+    void try_cancel() noexcept { connection_.try_cancel(); }
+
+private:
+    // consumer side, `request` is never concurrent with itself
+    std::size_t to_request_;
+    // producer side, `set_next` calls are never concurrent and the terminal comes after them
+    std::size_t to_deliver_;
+    StreamConnectionFor<StreamT, take_stream_slot_ctor> connection_;
+};
+
+template <SomeStream StreamT>
+struct [[nodiscard]] take_stream final {
+    using value_type = typename StreamT::value_type;
+    using error_type = typename StreamT::error_type;
+
+public:
+    constexpr take_stream(StreamT&& stream, std::size_t count) : stream_{ std::move(stream) }, count_{ count } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return take_stream_connection<StreamT, SlotCtorT>{ std::move(stream_), count_, std::move(slot_ctor) };
+    }
+
+    constexpr executor& get_executor() noexcept { return stream_.get_executor(); }
+
+private:
+    StreamT stream_;
+    std::size_t count_;
+};
+
+struct [[nodiscard]] take final {
+    constexpr explicit take(std::size_t count) : count_{ count } {}
+
+    template <SomeStream StreamT>
+    constexpr SomeStream auto operator()(StreamT&& stream) && noexcept {
+        return take_stream<StreamT>{ std::move(stream), count_ };
+    }
+
+private:
+    std::size_t count_;
+};
+
+} // namespace detail
+
+constexpr auto take(std::size_t count) noexcept { return detail::take{ count }; }
+
+} // namespace sl::exec
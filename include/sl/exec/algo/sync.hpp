@@ -6,6 +6,12 @@
 
 #include "sl/exec/algo/sync/serial.hpp"
 #include "sl/exec/algo/sync/mutex.hpp"
+#include "sl/exec/algo/sync/shared_mutex.hpp"
+
+#include "sl/exec/algo/sync/semaphore.hpp"
+#include "sl/exec/algo/sync/rate_limiter.hpp"
 
 #include "sl/exec/algo/sync/channel.hpp"
 #include "sl/exec/algo/sync/select.hpp"
+
+#include "sl/exec/algo/sync/cancellation.hpp"
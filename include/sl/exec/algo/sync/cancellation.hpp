@@ -0,0 +1,399 @@
+//
+// Created by usatiynyan.
+//
+// Stop-token style cancellation: a single `cancellation_source::request_cancel()` reaches every piece of work
+// that was given one of its tokens.
+// Callbacks are intrusive nodes, so (de)registration doesn't allocate and is O(1).
+// The list is guarded by a lock bit in the same word as the requested flag, the critical sections are a few pointer
+// writes, callbacks themselves are invoked outside of it.
+// Deregistration waits for the callback if it's being invoked by another thread, so that it's safe to destroy
+// the node right after, deregistering from within the callback itself doesn't wait.
+//
+// `with_cancellation(token)` attaches a token to a signal: the request is forwarded as `try_cancel()`,
+// so it reaches anything that supports cancellation (channel, select, semaphore, all/any, ...),
+// a coroutine that `co_await`s such a signal observes the request as null, same as for any other cancellation.
+//
+
+#pragma once
+
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/futex.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/intrusive/list.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/traits/unique.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <template <typename> typename Atomic>
+struct cancellation_callback_node
+    : meta::intrusive_list_node<cancellation_callback_node<Atomic>>
+    , meta::immovable {
+    virtual ~cancellation_callback_node() = default;
+    virtual void on_cancel() noexcept = 0;
+
+public:
+    bool is_queued = false; // protected via state lock
+    // points into the requester's frame while the callback is invoked, see `cancellation_state::deregister_callback`
+    bool* is_destroyed = nullptr;
+    Atomic<bool> is_invoked{ false };
+};
+
+template <template <typename> typename Atomic>
+struct [[nodiscard]] cancellation_state final : meta::immovable {
+    using node_type = cancellation_callback_node<Atomic>;
+
+private:
+    enum flag : std::uint32_t {
+        requested = 0b01,
+        locked = 0b10,
+    };
+
+public:
+    void incref() noexcept { refs_.fetch_add(1, std::memory_order::relaxed); }
+    void decref() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    [[nodiscard]] bool is_requested() const noexcept { return flags_.load(std::memory_order::acquire) & requested; }
+
+    // returns true only for the first request
+    bool request() noexcept {
+        if (!lock_unless_requested()) {
+            return false;
+        }
+        requester_ = std::this_thread::get_id();
+
+        while (node_type* node = callbacks_.pop_front()) {
+            node->is_queued = false;
+            bool is_destroyed = false;
+            node->is_destroyed = &is_destroyed;
+            unlock(requested);
+
+            node->on_cancel();
+            if (!is_destroyed) {
+                node->is_destroyed = nullptr;
+                node->is_invoked.store(true, std::memory_order::release);
+            }
+
+            lock();
+        }
+        unlock(requested);
+        return true;
+    }
+
+    // returns false if the cancellation was already requested, the callback is invoked inline then
+    bool register_callback(node_type& node) noexcept {
+        if (!lock_unless_requested()) {
+            node.on_cancel();
+            node.is_invoked.store(true, std::memory_order::relaxed);
+            return false;
+        }
+        node.is_queued = true;
+        callbacks_.push_back(&node);
+        unlock(0);
+        return true;
+    }
+
+    // only for registered callbacks
+    void deregister_callback(node_type& node) noexcept {
+        const std::uint32_t flags = lock();
+        if (std::exchange(node.is_queued, false)) {
+            std::ignore = callbacks_.erase(&node);
+            unlock(flags);
+            return;
+        }
+        unlock(flags);
+
+        // the callback is either being invoked or has already been
+        if (requester_ == std::this_thread::get_id() && node.is_destroyed != nullptr) {
+            *node.is_destroyed = true;
+            return;
+        }
+        while (!node.is_invoked.load(std::memory_order::acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::uint32_t lock() noexcept {
+        std::uint32_t flags = flags_.load(std::memory_order::relaxed);
+        while (true) {
+            if (flags & locked) {
+                cpu_relax();
+                flags = flags_.load(std::memory_order::relaxed);
+            } else if (flags_.compare_exchange_weak(
+                           flags, flags | locked, std::memory_order::acquire, std::memory_order::relaxed
+                       )) {
+                return flags;
+            }
+        }
+    }
+
+    bool lock_unless_requested() noexcept {
+        std::uint32_t flags = flags_.load(std::memory_order::acquire);
+        while (true) {
+            if (flags & requested) {
+                return false;
+            }
+            if (flags & locked) {
+                cpu_relax();
+                flags = flags_.load(std::memory_order::acquire);
+            } else if (flags_.compare_exchange_weak(
+                           flags, flags | locked, std::memory_order::acquire, std::memory_order::acquire
+                       )) {
+                return true;
+            }
+        }
+    }
+
+    void unlock(std::uint32_t flags) noexcept { flags_.store(flags, std::memory_order::release); }
+
+private:
+    Atomic<std::uint32_t> flags_{ 0 };
+    Atomic<std::uint32_t> refs_{ 1 };
+    meta::intrusive_list<node_type> callbacks_{}; // protected via lock bit
+    std::thread::id requester_{}; // written under lock before the first callback is invoked
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic>
+struct [[nodiscard]] cancellation_token final {
+    using state_type = detail::cancellation_state<Atomic>;
+
+public:
+    explicit cancellation_token(state_type* state) : state_{ state } { state_->incref(); }
+
+    cancellation_token(const cancellation_token& other) : cancellation_token{ other.state_ } {}
+    cancellation_token(cancellation_token&& other) noexcept : state_{ std::exchange(other.state_, nullptr) } {}
+    cancellation_token& operator=(const cancellation_token&) = delete;
+    cancellation_token& operator=(cancellation_token&&) = delete;
+
+    ~cancellation_token() noexcept {
+        if (state_ != nullptr) {
+            state_->decref();
+        }
+    }
+
+public:
+    [[nodiscard]] bool is_cancel_requested() const noexcept { return state_->is_requested(); }
+
+    state_type& state() & noexcept { return *state_; }
+
+private:
+    state_type* state_;
+};
+
+template <template <typename> typename Atomic = detail::atomic>
+struct [[nodiscard]] cancellation_source final : meta::immovable {
+    using state_type = detail::cancellation_state<Atomic>;
+
+public:
+    cancellation_source() : state_{ new state_type{} } {}
+    ~cancellation_source() noexcept { state_->decref(); }
+
+public:
+    // tokens keep the state alive, so they can outlive the source
+    cancellation_token<Atomic> token() & noexcept { return cancellation_token<Atomic>{ state_ }; }
+
+    // invokes the registered callbacks on the calling thread, returns true only for the first request
+    bool request_cancel() & noexcept { return state_->request(); }
+
+    [[nodiscard]] bool is_cancel_requested() const noexcept { return state_->is_requested(); }
+
+private:
+    state_type* state_;
+};
+
+// invokes `f` once cancellation is requested, inline if it already was, is deregistered on destruction
+template <typename F, template <typename> typename Atomic = detail::atomic>
+struct [[nodiscard]] cancellation_callback final : detail::cancellation_callback_node<Atomic> {
+    cancellation_callback(cancellation_token<Atomic> token, F f) : token_{ std::move(token) }, f_{ std::move(f) } {
+        is_registered_ = token_.state().register_callback(*this);
+    }
+    ~cancellation_callback() noexcept override {
+        if (is_registered_) {
+            token_.state().deregister_callback(*this);
+        }
+    }
+
+    void on_cancel() noexcept override { f_(); }
+
+private:
+    cancellation_token<Atomic> token_;
+    F f_;
+    bool is_registered_ = false;
+};
+
+namespace detail {
+
+// The upstream connection may complete (destroying the whole chain) right away,
+// so its result is held back until the upstream cancel handle is published.
+template <SomeSignal SignalT, typename SlotCtorT, template <typename> typename Atomic>
+struct [[nodiscard]] with_cancellation_connection final : cancellation_callback_node<Atomic> {
+    using value_type = typename SignalT::value_type;
+    using error_type = typename SignalT::error_type;
+    using result_type = meta::result<value_type, error_type>;
+
+private:
+    enum flag : std::uint32_t {
+        emitted = 0b001,
+        completed = 0b010,
+        cancel_requested = 0b100,
+    };
+
+    struct with_cancellation_slot {
+        with_cancellation_connection& self;
+
+        void set_value(value_type&& v) && noexcept { self.complete(result_type{ meta::ok_tag, std::move(v) }); }
+        void set_error(error_type&& e) && noexcept { self.complete(result_type{ meta::err_tag, std::move(e) }); }
+        void set_null() && noexcept { self.complete(meta::null); }
+    };
+
+    struct with_cancellation_slot_ctor {
+        with_cancellation_connection& self;
+
+        constexpr with_cancellation_slot operator()() && noexcept { return with_cancellation_slot{ self }; }
+    };
+
+    using connection_type = ConnectionFor<SignalT, with_cancellation_slot_ctor>;
+    using cancel_handle_type = decltype(std::declval<connection_type&&>().emit());
+
+public:
+    with_cancellation_connection(SignalT&& signal, SlotCtorT&& slot_ctor, cancellation_token<Atomic>&& token)
+        : slot_{ std::move(slot_ctor)() }, token_{ std::move(token) },
+          connection_{ std::move(signal).subscribe(with_cancellation_slot_ctor{ *this }) } {}
+
+    CancelHandle auto emit() && noexcept {
+        // can't touch `this` after completion, the handle is just a pointer
+        const proxy_cancel_handle handle{ this };
+
+        // an already requested cancellation is invoked inline, so the signal is not even emitted
+        if (!token_.state().register_callback(*this)) {
+            std::move(slot_).set_null();
+            return handle;
+        }
+        if (flags_.load(std::memory_order::acquire) & cancel_requested) {
+            token_.state().deregister_callback(*this);
+            std::move(slot_).set_null();
+            return handle;
+        }
+
+        cancel_handle_.emplace(std::move(connection_).emit());
+
+        // a cancellation that came before the handle was published is carried out here
+        std::uint32_t flags = flags_.load(std::memory_order::acquire);
+        bool is_cancelled = false;
+        while (true) {
+            if ((flags & cancel_requested) && !std::exchange(is_cancelled, true)) {
+                std::move(*cancel_handle_).try_cancel();
+            }
+            if (flags_.compare_exchange_weak(
+                    flags, flags | emitted, std::memory_order::acq_rel, std::memory_order::acquire
+                )) {
+                break;
+            }
+        }
+
+        if (flags & completed) {
+            finish(std::move(maybe_result_));
+        }
+        return handle;
+    }
+
+    void try_cancel() && noexcept { request_cancel(); }
+
+    void on_cancel() noexcept override { request_cancel(); }
+
+private:
+    void request_cancel() noexcept {
+        const std::uint32_t prev_flags = flags_.fetch_or(cancel_requested, std::memory_order::acq_rel);
+        if (!(prev_flags & cancel_requested) && (prev_flags & emitted)) {
+            std::move(*cancel_handle_).try_cancel();
+        }
+    }
+
+    void complete(meta::maybe<result_type> maybe_result) noexcept {
+        if (flags_.load(std::memory_order::acquire) & emitted) {
+            finish(std::move(maybe_result));
+            return;
+        }
+
+        maybe_result_ = std::move(maybe_result);
+        const std::uint32_t prev_flags = flags_.fetch_or(completed, std::memory_order::acq_rel);
+        if (prev_flags & emitted) {
+            finish(std::move(maybe_result_));
+        }
+    }
+
+    void finish(meta::maybe<result_type> maybe_result) noexcept {
+        // the callback may still be in flight on the requester
+        token_.state().deregister_callback(*this);
+        fulfill_slot(std::move(slot_), std::move(maybe_result));
+    }
+
+private:
+    SlotFrom<SlotCtorT> slot_;
+    cancellation_token<Atomic> token_;
+    connection_type connection_;
+    meta::maybe<cancel_handle_type> cancel_handle_{};
+    meta::maybe<result_type> maybe_result_{};
+    Atomic<std::uint32_t> flags_{ 0 };
+};
+
+template <SomeSignal SignalT, template <typename> typename Atomic>
+struct [[nodiscard]] with_cancellation_signal final {
+    using value_type = typename SignalT::value_type;
+    using error_type = typename SignalT::error_type;
+
+public:
+    with_cancellation_signal(SignalT&& signal, cancellation_token<Atomic>&& token)
+        : signal_{ std::move(signal) }, token_{ std::move(token) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return with_cancellation_connection<SignalT, SlotCtorT, Atomic>{
+            std::move(signal_),
+            std::move(slot_ctor),
+            std::move(token_),
+        };
+    }
+
+    constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
+
+private:
+    SignalT signal_;
+    cancellation_token<Atomic> token_;
+};
+
+template <template <typename> typename Atomic>
+struct [[nodiscard]] with_cancellation final {
+    template <SomeSignal SignalT>
+    constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
+        return with_cancellation_signal<SignalT, Atomic>{ std::move(signal), std::move(token) };
+    }
+
+public:
+    cancellation_token<Atomic> token;
+};
+
+} // namespace detail
+
+// null is delivered if the cancellation is requested before the signal completes
+template <template <typename> typename Atomic>
+constexpr auto with_cancellation(cancellation_token<Atomic> token) noexcept {
+    return detail::with_cancellation<Atomic>{ .token = std::move(token) };
+}
+
+} // namespace sl::exec
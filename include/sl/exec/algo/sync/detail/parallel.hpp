@@ -1,20 +1,30 @@
 //
 // Created by usatiynyan.
-// NOTE: parallel_connection breaks propagation of `try_cancel()`
+// Completion is a state machine over a couple of atomics, so cancellation and deletion are performed inline
+// by whoever comes last: the emitter holds a reference, so that the connection can't be deleted in the middle of `emit`,
+// and a cancellation request that comes in the middle of `emit` is carried out by the emitter.
+// Outer `try_cancel()` is forwarded to every child.
+// The connection is deleted after both it has completed and its owner has let go of it (see `parallel_connection_box`),
+// so that the owner is free to `try_cancel()` at any point.
 //
 
 #pragma once
 
-#include "sl/exec/algo/sync/serial.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 #include "sl/exec/thread/detail/polyfill.hpp"
 
-#include <sl/meta/match/overloaded.hpp>
+#include <sl/meta/assert.hpp>
 #include <sl/meta/monad/maybe.hpp>
 #include <sl/meta/tuple/for_each.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
 
 namespace sl::exec::detail {
 
@@ -24,53 +34,17 @@ private:
     static constexpr std::size_t N = sizeof...(ConnectionTs);
     using cancel_handles_type = std::tuple<decltype(std::declval<ConnectionTs&&>().emit())...>;
 
-    struct emit_task : task_node {
-        emit_task(parallel_connection& self, cancel_handles_type cancel_handles)
-            : cancel_handles_{ std::move(cancel_handles) }, self_{ self } {}
-
-        void execute() noexcept override { self_.serialized_emit(std::move(cancel_handles_)); }
-        void cancel() noexcept override {
-            // FIXME: leaking for now, should be alright
-        }
-
-    private:
-        cancel_handles_type cancel_handles_;
-        parallel_connection& self_;
-    };
-
-    struct try_cancel_beside_task : task_node {
-        try_cancel_beside_task(parallel_connection& self, std::size_t excluded_index)
-            : self_{ self }, excluded_index_{ excluded_index } {}
-
-        void execute() noexcept override { self_.serialized_try_cancel_beside(excluded_index_); }
-        void cancel() noexcept override {
-            // FIXME: leaking for now, should be alright
-        }
-
-    private:
-        parallel_connection& self_;
-        std::size_t excluded_index_;
-    };
-
-    struct delete_this_task : task_node {
-        explicit delete_this_task(parallel_connection& self) : self_{ self } {}
-
-        void execute() noexcept override { self_.serialized_delete_this(); }
-        void cancel() noexcept override { execute(); }
-
-    private:
-        parallel_connection& self_;
+    // the rest of the state is the excluded index of the cancellation request, N excludes none
+    enum state_flag : std::uint64_t {
+        emit_done = 0b01,
+        cancel_requested = 0b10,
     };
+    static constexpr std::uint64_t excluded_index_shift = 2;
 
 public:
     template <typename... LazyTs>
-    parallel_connection(
-        std::tuple<LazyTs...>&& lazy_connections,
-        serial_executor<Atomic>& an_executor,
-        DeleteThisT delete_this
-    )
-        : connections_{ std::move(lazy_connections) }, executor_{ an_executor },
-          delete_this_{ std::move(delete_this) } {}
+    parallel_connection(std::tuple<LazyTs...>&& lazy_connections, DeleteThisT delete_this)
+        : connections_{ std::move(lazy_connections) }, delete_this_{ std::move(delete_this) } {}
 
 public: // connection
     CancelHandle auto emit() && noexcept {
@@ -79,16 +53,26 @@ public: // connection
             std::move(connections_)
         );
         emit_impl(std::move(cancel_handles));
-        return dummy_cancel_handle{};
+        return proxy_cancel_handle{ this };
     }
 
     // all connections are subscribe_connection
     // Emit in sorted order by ordering, but store cancel_handles in ORIGINAL order
-    // This is critical: schedule_try_cancel_beside uses original indices
+    // This is critical: request_cancel_beside uses original indices
     CancelHandle auto emit_ordered() && noexcept {
         auto cancel_handles = emit_in_order(std::make_index_sequence<N>{});
         emit_impl(std::move(cancel_handles));
-        return dummy_cancel_handle{};
+        return proxy_cancel_handle{ this };
+    }
+
+    // requests every child to cancel, the owner has to still hold its reference
+    void try_cancel() && noexcept { request_cancel_beside(N); }
+
+    // called once by the completion, once by the emitter and once by the owner
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete_this_();
+        }
     }
 
 private:
@@ -111,8 +95,17 @@ private:
     }
 
     void emit_impl(cancel_handles_type cancel_handles) {
-        DEBUG_ASSERT(!tasks_.emit.has_value());
-        executor_.schedule(tasks_.emit.emplace(*this, std::move(cancel_handles)));
+        DEBUG_ASSERT(!cancel_handles_.has_value());
+        cancel_handles_.emplace(std::move(cancel_handles));
+
+        // a cancellation that came in the middle of emit is carried out here
+        const std::uint64_t prev_state = state_.fetch_or(emit_done, std::memory_order::acq_rel);
+        if (prev_state & cancel_requested) {
+            try_cancel_beside(static_cast<std::size_t>(prev_state >> excluded_index_shift));
+        }
+
+        // children could have completed already, the owner still holds its reference
+        release();
     }
 
 public: // parallel
@@ -122,94 +115,88 @@ public: // parallel
         return is_last;
     }
 
-    void schedule_try_cancel_beside(std::size_t excluded_index) {
-        DEBUG_ASSERT(!tasks_.try_cancel_beside.has_value());
-        executor_.schedule(tasks_.try_cancel_beside.emplace(*this, excluded_index));
-    }
-
-    void schedule_delete_this() {
-        DEBUG_ASSERT(!tasks_.delete_this.has_value());
-        executor_.schedule(tasks_.delete_this.emplace(*this));
+    // the first request wins, a child has to request before it's counted as completed
+    void request_cancel_beside(std::size_t excluded_index) noexcept {
+        std::uint64_t state = state_.load(std::memory_order::relaxed);
+        do {
+            if (state & cancel_requested) {
+                return;
+            }
+        } while (!state_.compare_exchange_weak(
+            state,
+            state | cancel_requested | (std::uint64_t{ excluded_index } << excluded_index_shift),
+            std::memory_order::acq_rel,
+            std::memory_order::relaxed
+        ));
+        if (state & emit_done) {
+            try_cancel_beside(excluded_index);
+        }
     }
 
-private: // serialized
+private:
     template <std::size_t... Is>
-    static void try_cancel_beside_impl(
-        cancel_handles_type& cancel_handles,
-        std::size_t excluded_index,
-        std::index_sequence<Is...>
-    ) {
+    void try_cancel_beside_impl(std::size_t excluded_index, std::index_sequence<Is...>) noexcept {
+        auto& cancel_handles = cancel_handles_.value();
         ((Is != excluded_index ? (std::move(std::get<Is>(cancel_handles)).try_cancel(), 0) : 0), ...);
     }
 
-    static void serialized_try_cancel_beside_impl(cancel_handles_type& cancel_handles, std::size_t excluded_index) {
-        try_cancel_beside_impl(cancel_handles, excluded_index, std::make_index_sequence<N>{});
+    void try_cancel_beside(std::size_t excluded_index) noexcept {
+        try_cancel_beside_impl(excluded_index, std::make_index_sequence<N>{});
     }
 
-    void serialized_emit(cancel_handles_type cancel_handles) {
-        state_.cancel_handles.emplace(std::move(cancel_handles));
+private:
+    std::tuple<ConnectionTs...> connections_;
 
-        // can't touch tasks_.try_cancel or tasks_.try_cancel_beside
-        if (state_.cancel_request.has_value()) {
-            serialized_try_cancel_beside_impl(state_.cancel_handles.value(), state_.cancel_request.value());
-            state_.cancel_request.reset();
-        }
+    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> counter_{ 0 };
+    // cold, they fill the rest of the line of `counter_` instead of taking one of their own
+    // written by the emitter before `emit_done`
+    meta::maybe<cancel_handles_type> cancel_handles_{};
+    DeleteThisT delete_this_;
 
-        if (state_.delete_requested) {
-            delete_this_();
-        }
-    }
+    alignas(hardware_destructive_interference_size) Atomic<std::uint64_t> state_{ 0 };
+    // the completion, the emitter and the owner
+    Atomic<std::uint32_t> refs_{ 3 };
 
-    void serialized_try_cancel_beside(std::size_t excluded_index) {
-        // try_cancel_beside already has signalled
-        if (state_.cancel_request.has_value()) {
-            return;
-        }
+public:
+    static constexpr std::string_view layout_name = "parallel_connection";
+    using layout_members = std::tuple<
+        std::tuple<ConnectionTs...>,
+        layout_aligned<Atomic<std::uint32_t>, hardware_destructive_interference_size>,
+        meta::maybe<cancel_handles_type>,
+        DeleteThisT,
+        layout_aligned<Atomic<std::uint64_t>, hardware_destructive_interference_size>,
+        Atomic<std::uint32_t>>;
+};
 
-        // cancelling during emit
-        if (!state_.cancel_handles.has_value()) {
-            state_.cancel_request.emplace(excluded_index);
-            return;
-        }
+// Owns the connection until `emit`, then only holds the owner's reference, so that the cancel handle stays valid.
+template <typename ConnectionT>
+struct parallel_connection_box final {
+    template <typename... Args>
+    explicit parallel_connection_box(Args&&... args)
+        : connection_{ std::make_unique<ConnectionT>(std::forward<Args>(args)...) } {}
 
-        serialized_try_cancel_beside_impl(state_.cancel_handles.value(), excluded_index);
-    }
+    parallel_connection_box(parallel_connection_box&& other) noexcept
+        : connection_{ std::move(other.connection_) }, emitted_{ std::exchange(other.emitted_, nullptr) } {}
 
-    void serialized_delete_this() {
-        // deleting during emit
-        if (!state_.cancel_handles.has_value()) {
-            state_.delete_requested = true;
-            return;
+    ~parallel_connection_box() noexcept {
+        if (emitted_ != nullptr) {
+            emitted_->release();
         }
+    }
 
-        delete_this_();
+    CancelHandle auto emit() && noexcept {
+        emitted_ = DEBUG_ASSERT_VAL(connection_.release());
+        return std::move(*emitted_).emit();
     }
 
 private:
-    std::tuple<ConnectionTs...> connections_;
-
-    serial_executor<Atomic>& executor_;
-    struct tasks {
-        meta::maybe<emit_task> emit{};
-        meta::maybe<try_cancel_beside_task> try_cancel_beside{};
-        meta::maybe<delete_this_task> delete_this{};
-    } tasks_;
-
-    struct state {
-        meta::maybe<cancel_handles_type> cancel_handles{};
-        meta::maybe<std::size_t> cancel_request{};
-        bool delete_requested = false;
-    } state_;
+    std::unique_ptr<ConnectionT> connection_;
+    ConnectionT* emitted_ = nullptr;
 
-    DeleteThisT delete_this_;
-
-    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> counter_{ 0 };
+public:
+    static constexpr std::string_view layout_name = "parallel_connection_box";
+    using layout_members = std::tuple<std::unique_ptr<ConnectionT>, ConnectionT*>;
+    using layout_allocated = std::tuple<ConnectionT>;
 };
 
-template <template <typename> typename Atomic>
-serial_executor<Atomic>& inline_serial_executor() {
-    static serial_executor<Atomic> impl{ inline_executor() };
-    return impl;
-}
-
 } // namespace sl::exec::detail
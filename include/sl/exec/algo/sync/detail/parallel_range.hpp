@@ -0,0 +1,165 @@
+//
+// Created by usatiynyan.
+// Fan-out over a runtime amount of homogeneous connections.
+// Owner and its elements share a single allocation, see `parallel_range_block`.
+// Completion is tracked by an atomic counter, there's no executor to serialize on:
+// the emitting thread holds an extra reference, so the owner can't be deleted in the middle of `emit`,
+// and the first cancellation request is performed either by the requester or by the emitter, whichever is the latter.
+// The owner is kept alive until both the result is delivered and the outer connection lets go of it,
+// so that outer `try_cancel()` could be forwarded to every child at any point.
+//
+
+#pragma once
+
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/monad/maybe.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace sl::exec::detail {
+
+// [OwnerT | padding | ElementT x size]
+template <typename OwnerT, typename ElementT>
+struct parallel_range_block {
+    static constexpr std::size_t elements_offset =
+        (sizeof(OwnerT) + alignof(ElementT) - 1) / alignof(ElementT) * alignof(ElementT);
+    static constexpr std::align_val_t alignment{ std::max(alignof(OwnerT), alignof(ElementT)) };
+
+    template <typename... Args>
+    static OwnerT* create(std::size_t size, Args&&... args) {
+        void* memory = ::operator new(elements_offset + size * sizeof(ElementT), alignment);
+        return ::new (memory) OwnerT{ std::forward<Args>(args)... };
+    }
+
+    static void destroy(OwnerT* owner) noexcept {
+        owner->~OwnerT();
+        ::operator delete(static_cast<void*>(owner), alignment);
+    }
+
+    // storage is uninitialized until the owner constructs the elements
+    static ElementT* elements(OwnerT* owner) noexcept {
+        return reinterpret_cast<ElementT*>(reinterpret_cast<std::byte*>(owner) + elements_offset);
+    }
+};
+
+template <typename ConnectionT, typename StorageT, template <typename> typename Atomic>
+struct parallel_range {
+    using cancel_handle_type = decltype(std::declval<ConnectionT&&>().emit());
+
+    struct element {
+        template <typename SignalT, typename SlotCtorT>
+        element(SignalT&& signal, SlotCtorT&& slot_ctor)
+            : connection{ std::move(signal).subscribe(std::move(slot_ctor)) } {}
+
+        ConnectionT connection;
+        meta::maybe<cancel_handle_type> cancel_handle{};
+        // written by the element's own slot
+        meta::maybe<StorageT> storage{};
+    };
+
+private:
+    // the rest of the state is the excluded index of the cancellation request
+    enum state_flag : std::uint64_t {
+        emit_done = 0b01,
+        cancel_requested = 0b10,
+    };
+    static constexpr std::uint64_t excluded_index_shift = 2;
+
+public:
+    template <typename SignalT, typename MakeSlotCtorT>
+    parallel_range(element* elements, std::vector<SignalT>&& signals, MakeSlotCtorT&& make_slot_ctor)
+        : elements_{ elements }, size_{ signals.size() }, remaining_{ static_cast<std::uint32_t>(size_ + 1) } {
+        for (std::size_t i = 0; i != size_; ++i) {
+            ::new (static_cast<void*>(elements_ + i)) element{ std::move(signals[i]), make_slot_ctor(i) };
+        }
+    }
+
+    ~parallel_range() noexcept {
+        for (std::size_t i = 0; i != size_; ++i) {
+            elements_[i].~element();
+        }
+    }
+
+    parallel_range(const parallel_range&) = delete;
+    parallel_range& operator=(const parallel_range&) = delete;
+
+public:
+    // returns true if the caller has to finish the owner
+    [[nodiscard]] bool emit() noexcept {
+        std::size_t emitted = 0;
+        // no point in emitting the rest, when the result is already decided
+        for (; emitted != size_ && !(state_.load(std::memory_order::acquire) & cancel_requested); ++emitted) {
+            element& an_element = elements_[emitted];
+            an_element.cancel_handle.emplace(std::move(an_element.connection).emit());
+        }
+        emitted_ = emitted;
+
+        const std::uint64_t prev_state = state_.fetch_or(emit_done, std::memory_order::acq_rel);
+        if (prev_state & cancel_requested) {
+            try_cancel_beside(static_cast<std::size_t>(prev_state >> excluded_index_shift));
+        }
+
+        // skipped elements are never going to complete
+        return release(static_cast<std::uint32_t>(size_ - emitted + 1));
+    }
+
+    // the first request wins, an element has to request before it is released
+    void request_cancel_beside(std::size_t excluded_index) noexcept {
+        std::uint64_t state = state_.load(std::memory_order::relaxed);
+        do {
+            if (state & cancel_requested) {
+                return;
+            }
+        } while (!state_.compare_exchange_weak(
+            state,
+            state | cancel_requested | (std::uint64_t{ excluded_index } << excluded_index_shift),
+            std::memory_order::acq_rel,
+            std::memory_order::relaxed
+        ));
+        if (state & emit_done) {
+            try_cancel_beside(excluded_index);
+        }
+    }
+
+    // outer cancellation, the owner has to still hold its reference
+    void request_cancel_all() noexcept { request_cancel_beside(size_); }
+
+    // synchronizes storage of the released elements w/ the one that gets `true`
+    [[nodiscard]] bool release(std::uint32_t diff = 1) noexcept {
+        return remaining_.fetch_sub(diff, std::memory_order::acq_rel) == diff;
+    }
+
+    // called once after the result is delivered and once by the owner, true means the owner has to be destroyed
+    [[nodiscard]] bool release_ref() noexcept { return refs_.fetch_sub(1, std::memory_order::acq_rel) == 1; }
+
+    std::size_t size() const noexcept { return size_; }
+    meta::maybe<StorageT>& storage(std::size_t index) noexcept { return elements_[index].storage; }
+
+private:
+    void try_cancel_beside(std::size_t excluded_index) noexcept {
+        for (std::size_t i = 0; i != emitted_; ++i) {
+            if (i != excluded_index) {
+                std::move(elements_[i].cancel_handle.value()).try_cancel();
+            }
+        }
+    }
+
+private:
+    element* elements_;
+    std::size_t size_;
+    // written by the emitter before `emit_done`
+    std::size_t emitted_ = 0;
+
+    alignas(hardware_destructive_interference_size) Atomic<std::uint64_t> state_{ 0 };
+    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> remaining_;
+    Atomic<std::uint32_t> refs_{ 2 };
+};
+
+} // namespace sl::exec::detail
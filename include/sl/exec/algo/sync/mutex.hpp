@@ -1,48 +1,217 @@
 //
 // Created by usatiynyan.
 //
+// Based on cppcoro's async_mutex:
+// the state is either unlocked, locked w/o waiters, or the head of a stack of newly arrived waiters.
+// Uncontended lock is a single CAS and completes inline, contended lock pushes itself onto the stack.
+// The owner moves the stack into its local FIFO on unlock and hands the lock directly to the next waiter.
+// The lock is released (or handed off) when the unlock signal is emitted, not when it's built.
+//
 
 #pragma once
 
-#include "sl/exec/algo/make/result.hpp"
-#include "sl/exec/algo/sched/on.hpp"
-#include "sl/exec/algo/sync/serial.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
 
 #include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+#include <sl/meta/assert.hpp>
 #include <sl/meta/traits/unique.hpp>
 
+#include <bit>
+#include <cstdint>
+#include <utility>
+
 namespace sl::exec {
+namespace detail {
+
+// `Atomic`-independent part of the mutex, so that `mutex_lock` doesn't have to be a template
+struct mutex_base {
+    // owner only
+    virtual void unlock() noexcept = 0;
+    virtual executor& get_executor() const noexcept = 0;
+
+protected:
+    ~mutex_base() = default;
+};
+
+template <template <typename> typename Atomic>
+struct mutex_impl final : mutex_base {
+    using node_type = meta::intrusive_forward_list_node<task_node>;
+
+    static constexpr std::uintptr_t unlocked = 0;
+    static constexpr std::uintptr_t locked_no_waiters = 1;
+
+public:
+    constexpr explicit mutex_impl(executor& executor) : executor_{ executor } {}
+
+    // returns true if the lock is acquired, otherwise waiter is going to be scheduled when the lock is handed off
+    [[nodiscard]] bool lock_or_enqueue(task_node& waiter) {
+        node_type* const waiter_node = &waiter;
+        std::uintptr_t state = state_.load(std::memory_order::relaxed);
+        while (true) {
+            if (state == unlocked) {
+                if (state_.compare_exchange_weak(
+                        state, locked_no_waiters, std::memory_order::acquire, std::memory_order::relaxed
+                    )) {
+                    return true;
+                }
+                continue;
+            }
+
+            waiter_node->intrusive_next = state == locked_no_waiters ? nullptr : std::bit_cast<node_type*>(state);
+            const auto new_state = std::bit_cast<std::uintptr_t>(waiter_node);
+            if (state_.compare_exchange_weak(
+                    state, new_state, std::memory_order::release, std::memory_order::relaxed
+                )) {
+                return false;
+            }
+        }
+    }
+
+    void unlock() noexcept override {
+        if (waiters_.empty()) {
+            std::uintptr_t expected = locked_no_waiters;
+            if (state_.compare_exchange_strong(
+                    expected, unlocked, std::memory_order::release, std::memory_order::relaxed
+                )) {
+                return;
+            }
+
+            // the stack is LIFO, so pushing to the front in the walk order restores the arrival order
+            std::uintptr_t stack = state_.exchange(locked_no_waiters, std::memory_order::acquire);
+            DEBUG_ASSERT(stack != unlocked && stack != locked_no_waiters);
+            for (node_type* current = std::bit_cast<node_type*>(stack); current != nullptr;) {
+                node_type* const next = current->intrusive_next;
+                waiters_.push_front(current);
+                current = next;
+            }
+        }
+
+        // the lock is not released, the next waiter becomes the owner
+        task_node* next_owner = waiters_.pop_front();
+        DEBUG_ASSERT(next_owner != nullptr);
+        executor_.schedule(*next_owner);
+    }
+
+    executor& get_executor() const noexcept override { return executor_; }
+
+private:
+    alignas(hardware_destructive_interference_size) Atomic<std::uintptr_t> state_{ unlocked };
+    task_list waiters_{}; // owner only
+    executor& executor_;
+};
+
+struct [[nodiscard]] mutex_unlock_signal final {
+    using value_type = meta::unit;
+    using error_type = meta::undefined;
+
+    template <typename SlotCtorT>
+    struct [[nodiscard]] connection_type final {
+        connection_type(SlotCtorT&& slot_ctor, mutex_base& impl) : slot_{ std::move(slot_ctor)() }, impl_{ impl } {}
+
+        CancelHandle auto emit() && noexcept {
+            impl_.unlock();
+            std::move(slot_).set_value(meta::unit{});
+            return dummy_cancel_handle{};
+        }
+
+    private:
+        SlotFrom<SlotCtorT> slot_;
+        mutex_base& impl_;
+    };
+
+    mutex_base& impl;
+    executor& ex;
+
+public:
+    template <SlotCtorFor<mutex_unlock_signal> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return connection_type<SlotCtorT>{ std::move(slot_ctor), impl };
+    }
+
+    // released inline, the continuation is scheduled
+    executor& get_executor() noexcept { return ex; }
+};
+
+} // namespace detail
 
 struct [[nodiscard]] mutex_lock final : meta::unique {
-    constexpr explicit mutex_lock(executor& executor) : executor_{ executor } {}
+    constexpr explicit mutex_lock(detail::mutex_base& impl) : impl_{ impl } {}
     mutex_lock(mutex_lock&& other) noexcept
-        : executor_{ other.executor_ }, is_locked_{ std::exchange(other.is_locked_, false) } {}
+        : impl_{ other.impl_ }, is_locked_{ std::exchange(other.is_locked_, false) } {}
     ~mutex_lock() noexcept { ASSERT(!is_locked_); }
 
-    constexpr Signal<meta::unit, meta::undefined> auto unlock() && {
-        is_locked_ = false;
-        return start_on(executor_);
-    }
+    // the lock is released (or handed off) once the returned signal is emitted
     constexpr Signal<meta::unit, meta::undefined> auto unlock_on(executor& executor) && {
+        DEBUG_ASSERT(is_locked_);
         is_locked_ = false;
-        return start_on(executor);
+        return detail::mutex_unlock_signal{ .impl = impl_, .ex = executor };
+    }
+    constexpr Signal<meta::unit, meta::undefined> auto unlock() && {
+        return std::move(*this).unlock_on(impl_.get_executor());
     }
 
 private:
-    executor& executor_;
+    detail::mutex_base& impl_;
     bool is_locked_ = true;
 };
 
+namespace detail {
+
+template <template <typename> typename Atomic>
+struct [[nodiscard]] mutex_lock_signal final {
+    using value_type = mutex_lock;
+    using error_type = meta::undefined;
+
+    template <typename SlotCtorT>
+    struct [[nodiscard]] connection_type final : task_node {
+        connection_type(SlotCtorT&& slot_ctor, mutex_impl<Atomic>& impl)
+            : slot_{ std::move(slot_ctor)() }, impl_{ impl } {}
+
+        CancelHandle auto emit() && noexcept {
+            if (impl_.lock_or_enqueue(*this)) {
+                execute();
+            }
+            return dummy_cancel_handle{};
+        }
+
+        void execute() noexcept override { std::move(slot_).set_value(value_type{ impl_ }); }
+        void cancel() noexcept override {
+            // the lock was already handed off to this waiter
+            impl_.unlock();
+            std::move(slot_).set_null();
+        }
+
+    private:
+        SlotFrom<SlotCtorT> slot_;
+        mutex_impl<Atomic>& impl_;
+    };
+
+    mutex_impl<Atomic>& impl;
+
+public:
+    template <SlotCtorFor<mutex_lock_signal> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return connection_type<SlotCtorT>{ std::move(slot_ctor), impl };
+    }
+
+    // either inline on the caller of `lock`, or on the executor after hand off
+    static executor& get_executor() noexcept { return inline_executor(); }
+};
+
+} // namespace detail
+
 template <template <typename> typename Atomic = detail::atomic>
 struct [[nodiscard]] mutex final {
-    constexpr explicit mutex(executor& executor) : serial_executor_{ executor } {}
+    constexpr explicit mutex(executor& executor) : impl_{ executor } {}
 
     constexpr Signal<mutex_lock, meta::undefined> auto lock() {
-        return value_as_signal(mutex_lock{ serial_executor_.get_inner() }) | continue_on(serial_executor_);
+        return detail::mutex_lock_signal<Atomic>{ .impl = impl_ };
     }
 
 private:
-    serial_executor<Atomic> serial_executor_;
+    detail::mutex_impl<Atomic> impl_;
 };
 
 } // namespace sl::exec
@@ -0,0 +1,79 @@
+//
+// Created by usatiynyan.
+//
+// Token bucket on top of `semaphore`: tokens are permits, which are never given back by the consumers.
+// The bucket is refilled lazily by `refill`, whoever owns a timer (or a polling loop) drives it,
+// `next_refill` tells when the next token is due.
+//
+
+#pragma once
+
+#include "sl/exec/algo/sync/semaphore.hpp"
+#include "sl/exec/thread/detail/mutex.hpp"
+
+#include <sl/meta/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace sl::exec {
+
+template <typename Clock = std::chrono::steady_clock, typename Mutex = detail::mutex>
+struct [[nodiscard]] rate_limiter final {
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+    // starts full, one token is added every `period` up to `capacity`
+    rate_limiter(std::size_t capacity, duration period, time_point now = Clock::now())
+        : semaphore_{ capacity }, capacity_{ capacity }, period_{ period }, last_refill_{ now } {
+        DEBUG_ASSERT(capacity > 0 && period > duration::zero());
+    }
+
+    // `count` must not exceed capacity, otherwise it is never satisfied
+    constexpr Signal<meta::unit, meta::undefined> auto acquire(std::size_t count = 1) & {
+        DEBUG_ASSERT(count <= capacity_);
+        return semaphore_.acquire(count);
+    }
+
+    [[nodiscard]] bool try_acquire(std::size_t count = 1) & { return semaphore_.try_acquire(count); }
+
+    // returns the number of tokens added
+    std::size_t refill(time_point now = Clock::now()) & {
+        std::unique_lock<Mutex> lock{ m_ };
+        if (now <= last_refill_) {
+            return 0;
+        }
+
+        const auto periods = (now - last_refill_) / period_;
+        // only refills change the amount upwards, so the headroom may only be underestimated here
+        const std::size_t headroom = capacity_ - std::min(capacity_, semaphore_.available());
+        const auto tokens = static_cast<std::size_t>(std::min<decltype(periods)>(periods, headroom));
+        // a full bucket does not accumulate time, the remainder of a partial period is kept
+        last_refill_ = std::cmp_equal(tokens, periods) ? last_refill_ + period_ * periods : now;
+        lock.unlock();
+
+        if (tokens > 0) {
+            semaphore_.release(tokens);
+        }
+        return tokens;
+    }
+
+    time_point next_refill() & {
+        std::lock_guard<Mutex> lock{ m_ };
+        return last_refill_ + period_;
+    }
+
+    std::size_t available() & { return semaphore_.available(); }
+
+private:
+    semaphore<Mutex> semaphore_;
+    std::size_t capacity_;
+    duration period_;
+    time_point last_refill_;
+    Mutex m_{};
+};
+
+} // namespace sl::exec
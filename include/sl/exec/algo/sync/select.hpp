@@ -17,6 +17,7 @@
 
 #include "sl/exec/algo/make/result.hpp"
 #include "sl/exec/algo/sync/detail/parallel.hpp"
+#include "sl/exec/algo/sync/serial.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/thread/detail/atomic.hpp"
 #include "sl/exec/thread/detail/multiword_kcas.hpp"
@@ -108,9 +109,8 @@ private:
     }
 
 public:
-    select_connection(std::tuple<SelectCaseTs...>&& cases, serial_executor<Atomic>& an_executor, SlotCtorT slot_ctor)
+    select_connection(std::tuple<SelectCaseTs...>&& cases, SlotCtorT slot_ctor)
         : parallel_{ make_connections(*this, std::move(cases), std::make_index_sequence<N>()),
-                     an_executor,
                      select_delete_this{ this } },
           slot_{ std::move(slot_ctor)() } {}
 
@@ -127,6 +127,7 @@ public: // connection
             return std::move(parallel_).emit_ordered();
         }
     }
+    void release() noexcept { parallel_.release(); }
 
 private:
     [[nodiscard]] bool check_done() noexcept { return kcas(kcas_arg<std::size_t>{ .a = &done_, .e = 0, .n = 1 }); }
@@ -136,12 +137,12 @@ private:
         if (!CheckDone || check_done()) {
             ValueT value = std::move(case_functor)(std::move(case_value));
             std::move(slot_).set_value(std::move(value));
-            parallel_.schedule_try_cancel_beside(index);
+            parallel_.request_cancel_beside(index);
         }
 
         const bool is_last = parallel_.increment_and_check();
         if (is_last) {
-            parallel_.schedule_delete_this();
+            parallel_.release();
         }
     }
 
@@ -155,7 +156,7 @@ private:
             std::move(slot_).set_error(meta::unit{});
         }
 
-        parallel_.schedule_delete_this();
+        parallel_.release();
     }
 
     void set_null_impl() noexcept {
@@ -168,7 +169,7 @@ private:
             std::move(slot_).set_null();
         }
 
-        parallel_.schedule_delete_this();
+        parallel_.release();
     }
 
 private:
@@ -177,27 +178,6 @@ private:
     alignas(hardware_destructive_interference_size) Atomic<std::size_t> done_{ 0 }; // word-size for CAS2
 };
 
-template <template <typename> typename Atomic, typename ValueT, typename SlotCtorT, typename... SelectCaseTs>
-struct select_connection_box final {
-    using connection_type = select_connection<Atomic, ValueT, SlotCtorT, SelectCaseTs...>;
-
-public:
-    select_connection_box(
-        std::tuple<SelectCaseTs...>&& cases,
-        serial_executor<Atomic>& an_executor,
-        SlotCtorT slot_ctor
-    )
-        : connection_{ std::make_unique<connection_type>(std::move(cases), an_executor, std::move(slot_ctor)) } {}
-
-    CancelHandle auto emit() && noexcept {
-        auto& a_connection = *DEBUG_ASSERT_VAL(connection_.release());
-        return std::move(a_connection).emit();
-    }
-
-private:
-    std::unique_ptr<connection_type> connection_;
-};
-
 template <template <typename> typename Atomic, typename ValueT, typename... SelectCaseTs>
 struct [[nodiscard]] select final {
     using value_type = ValueT;
@@ -206,15 +186,11 @@ struct [[nodiscard]] select final {
 
 public:
     template <typename SelectCaseT>
-    explicit constexpr select(SelectCaseT&& a_case, serial_executor<Atomic>& an_executor)
+    explicit constexpr select(SelectCaseT&& a_case, executor& an_executor)
         : cases_{ std::move(a_case) }, executor_{ an_executor } {}
 
     template <typename PrevSelectCasesTuple, typename SelectCaseT>
-    explicit constexpr select(
-        PrevSelectCasesTuple&& prev_cases,
-        SelectCaseT&& a_case,
-        serial_executor<Atomic>& an_executor
-    )
+    explicit constexpr select(PrevSelectCasesTuple&& prev_cases, SelectCaseT&& a_case, executor& an_executor)
         : cases_{ std::tuple_cat(std::move(prev_cases), std::make_tuple(std::move(a_case))) },
           executor_{ an_executor } {}
 
@@ -239,23 +215,24 @@ public:
 public: // SomeSignal
     template <SlotCtor<value_type, error_type> SlotCtorT>
     constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
-        return select_connection_box<Atomic, ValueT, SlotCtorT, SelectCaseTs...>{
+        using connection_type = select_connection<Atomic, ValueT, SlotCtorT, SelectCaseTs...>;
+        return parallel_connection_box<connection_type>{
             std::move(cases_),
-            executor_,
             std::move(slot_ctor),
         };
     }
 
-    executor& get_executor() noexcept { return executor_.get_inner(); }
+    // the result is delivered inline by the signal that decides it, the continuation is scheduled onto this one
+    executor& get_executor() noexcept { return executor_; }
 
 private:
     std::tuple<SelectCaseTs...> cases_;
-    serial_executor<Atomic>& executor_;
+    executor& executor_;
 };
 
 template <template <typename> typename Atomic>
 struct [[nodiscard]] select_start final {
-    explicit constexpr select_start(serial_executor<Atomic>& an_executor) : executor_{ an_executor } {}
+    explicit constexpr select_start(executor& an_executor) : executor_{ an_executor } {}
 
     template <SomeSignal SomeSignalT, SelectFunctorFor<SomeSignalT> F>
     auto case_(SomeSignalT&& signal, F&& functor) {
@@ -267,18 +244,24 @@ struct [[nodiscard]] select_start final {
     }
 
 private:
-    serial_executor<Atomic>& executor_;
+    executor& executor_;
 };
 
 } // namespace detail
 
 template <template <typename> typename Atomic>
-constexpr auto select_(serial_executor<Atomic>& an_executor = detail::inline_serial_executor<Atomic>()) {
+constexpr auto select_(executor& an_executor = inline_executor()) {
     return detail::select_start<Atomic>{ an_executor };
 }
 
-constexpr auto select(serial_executor<detail::atomic>& an_executor = detail::inline_serial_executor<detail::atomic>()) {
-    return select_<detail::atomic>(an_executor);
+// nothing is serialized on it anymore, the continuation goes to the underlying executor
+template <template <typename> typename Atomic>
+constexpr auto select_(serial_executor<Atomic>& an_executor) {
+    return select_<Atomic>(an_executor.get_inner());
 }
 
+constexpr auto select(executor& an_executor = inline_executor()) { return select_<detail::atomic>(an_executor); }
+
+constexpr auto select(serial_executor<detail::atomic>& an_executor) { return select_<detail::atomic>(an_executor); }
+
 } // namespace sl::exec
@@ -0,0 +1,178 @@
+//
+// Created by usatiynyan.
+//
+// Waiters are served strictly in FIFO order: a large `acquire(n)` at the head blocks the smaller ones behind it,
+// which keeps it from being starved.
+//
+
+#pragma once
+
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/mutex.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/intrusive/list.hpp>
+#include <sl/meta/traits/unique.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+template <typename Mutex>
+struct [[nodiscard]] semaphore_impl final {
+    struct waiter
+        : meta::intrusive_list_node<waiter>
+        , meta::immovable {
+        virtual ~waiter() = default;
+        virtual void set_value() noexcept = 0;
+        virtual void set_null() noexcept = 0;
+
+    public:
+        std::size_t count = 0;
+        bool is_queued = false; // protected via semaphore mutex
+    };
+
+public:
+    constexpr explicit semaphore_impl(std::size_t permits) : permits_{ permits } {}
+
+    void acquire(waiter& a_waiter) & {
+        std::unique_lock<Mutex> lock{ m_ };
+        if (waiters_.empty() && permits_ >= a_waiter.count) {
+            permits_ -= a_waiter.count;
+            lock.unlock();
+            a_waiter.set_value();
+            return;
+        }
+        a_waiter.is_queued = true;
+        waiters_.push_back(&a_waiter);
+    }
+
+    bool try_acquire(std::size_t count) & {
+        std::lock_guard<Mutex> lock{ m_ };
+        if (!waiters_.empty() || permits_ < count) {
+            return false;
+        }
+        permits_ -= count;
+        return true;
+    }
+
+    void release(std::size_t count) & {
+        std::unique_lock<Mutex> lock{ m_ };
+        permits_ += count;
+        grant_and_unlock(lock);
+    }
+
+    void unacquire(waiter& a_waiter) & {
+        std::unique_lock<Mutex> lock{ m_ };
+        if (!std::exchange(a_waiter.is_queued, false)) {
+            // already granted
+            return;
+        }
+        const bool was_head = waiters_.front() == &a_waiter;
+        std::ignore = waiters_.erase(&a_waiter);
+        if (was_head) {
+            // the removed head could have been the only thing holding back the rest of the queue
+            grant_and_unlock(lock);
+        } else {
+            lock.unlock();
+        }
+        a_waiter.set_null();
+    }
+
+    std::size_t available() & {
+        std::lock_guard<Mutex> lock{ m_ };
+        return permits_;
+    }
+
+private:
+    void grant_and_unlock(std::unique_lock<Mutex>& lock) {
+        meta::intrusive_list<waiter> granted;
+        while (waiter* head = waiters_.front()) {
+            if (head->count > permits_) {
+                break;
+            }
+            permits_ -= head->count;
+            head->is_queued = false;
+            std::ignore = waiters_.erase(head);
+            granted.push_back(head);
+        }
+        lock.unlock();
+
+        while (waiter* a_waiter = granted.pop_front()) {
+            a_waiter->set_value();
+        }
+    }
+
+private:
+    meta::intrusive_list<waiter> waiters_;
+    std::size_t permits_;
+    Mutex m_{};
+};
+
+template <typename Mutex>
+struct [[nodiscard]] semaphore_acquire_signal final {
+    using impl_type = semaphore_impl<Mutex>;
+
+    using value_type = meta::unit;
+    using error_type = meta::undefined;
+
+    template <typename SlotCtorT>
+    struct [[nodiscard]] connection_type final : impl_type::waiter {
+        connection_type(SlotCtorT&& slot_ctor, std::size_t count, impl_type& impl)
+            : slot_{ std::move(slot_ctor)() }, impl_{ impl } {
+            impl_type::waiter::count = count;
+        }
+
+        CancelHandle auto emit() && noexcept {
+            impl_.acquire(*this);
+            return proxy_cancel_handle{ this };
+        }
+        void try_cancel() && noexcept { impl_.unacquire(*this); }
+
+        void set_value() noexcept override { std::move(slot_).set_value(meta::unit{}); }
+        void set_null() noexcept override { std::move(slot_).set_null(); }
+
+    private:
+        SlotFrom<SlotCtorT> slot_;
+        impl_type& impl_;
+    };
+
+    std::size_t count;
+    impl_type& impl;
+
+public:
+    template <SlotCtorFor<semaphore_acquire_signal> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return connection_type<SlotCtorT>{ std::move(slot_ctor), count, impl };
+    }
+
+    static executor& get_executor() noexcept { return inline_executor(); }
+};
+
+} // namespace detail
+
+template <typename Mutex = detail::mutex>
+struct [[nodiscard]] semaphore final {
+    constexpr explicit semaphore(std::size_t permits) : impl_{ permits } {}
+
+    // completes inline either on the caller of `acquire` or on the caller of `release` that satisfied it
+    constexpr Signal<meta::unit, meta::undefined> auto acquire(std::size_t count = 1) & {
+        return detail::semaphore_acquire_signal<Mutex>{ .count = count, .impl = impl_ };
+    }
+
+    // does not overtake queued waiters
+    [[nodiscard]] bool try_acquire(std::size_t count = 1) & { return impl_.try_acquire(count); }
+
+    void release(std::size_t count = 1) & { impl_.release(count); }
+
+    std::size_t available() & { return impl_.available(); }
+
+private:
+    detail::semaphore_impl<Mutex> impl_;
+};
+
+} // namespace sl::exec
@@ -7,33 +7,68 @@
 #include "sl/exec/model/executor.hpp"
 
 #include "sl/exec/thread/detail/atomic.hpp"
-#include "sl/exec/thread/detail/lock_free_stack.hpp"
+#include "sl/exec/thread/detail/metrics.hpp"
+#include "sl/exec/thread/detail/mpsc_queue.hpp"
 #include "sl/exec/thread/detail/polyfill.hpp"
+#include "sl/exec/thread/detail/trace.hpp"
 
-#include <sl/meta/intrusive/algorithm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
 
 namespace sl::exec {
 
+// after either limit is reached, the strand yields back to the underlying executor, letting unrelated work through
+struct serial_executor_budget {
+    std::uint32_t max_tasks = std::numeric_limits<std::uint32_t>::max();
+    std::chrono::nanoseconds max_duration = std::chrono::nanoseconds::max();
+};
+
+struct serial_executor_stats {
+    std::uint32_t queue_depth;
+    std::uint64_t runs;
+    std::uint64_t executed;
+    std::uint64_t yields;
+};
+
 template <template <typename> typename Atomic = detail::atomic>
 struct serial_executor : executor {
 private:
+    using node_type = meta::intrusive_forward_list_node<task_node>;
+
     struct serial_executor_task final : task_node {
         constexpr explicit serial_executor_task(serial_executor& self) : self_{ self } {}
 
         void execute() noexcept override {
-            auto* head = self_.batch_.extract(); // acquire task
-            DEBUG_ASSERT(head != nullptr);
-
-            auto* tail = meta::intrusive_forward_list_node_reverse(head);
+            const serial_executor_budget& budget = self_.budget_;
+            const bool is_time_bound = budget.max_duration != std::chrono::nanoseconds::max();
+            const auto start =
+                is_time_bound ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
 
             std::uint32_t batch_size = 0;
-            meta::intrusive_forward_list_node_for_each(tail, [&batch_size](task_node* a_task_node) {
+            bool is_budget_exhausted = false;
+            while (node_type* current = self_.pop_counted(batch_size)) {
+                task_node* current_task = current->downcast();
+                const auto execute_begin = self_.metrics_.on_execute_begin(*current_task);
+                {
+                    detail::trace_execute_scope trace_scope{ "serial", &self_ };
+                    current_task->execute();
+                }
+                self_.metrics_.on_execute_end(execute_begin);
                 ++batch_size;
-                a_task_node->execute();
-            });
+
+                if (batch_size >= budget.max_tasks
+                    || (is_time_bound && std::chrono::steady_clock::now() - start >= budget.max_duration)) {
+                    is_budget_exhausted = true;
+                    break;
+                }
+            }
 
             const std::uint32_t work_before_batch = self_.work_.fetch_sub(batch_size, std::memory_order::relaxed);
-            if (work_before_batch > batch_size) {
+            const bool has_more = work_before_batch > batch_size;
+            self_.record_run(batch_size, /* yielded = */ has_more && is_budget_exhausted);
+            if (has_more) {
                 self_.executor_.schedule(*this);
             }
         }
@@ -44,10 +79,13 @@ private:
     };
 
 public:
-    constexpr explicit serial_executor(executor& an_executor) : task_{ *this }, executor_{ an_executor } {}
+    constexpr explicit serial_executor(executor& an_executor, serial_executor_budget budget = {})
+        : task_{ *this }, executor_{ an_executor }, budget_{ budget } {}
 
     void schedule(task_node& a_task_node) noexcept override {
-        batch_.push(&a_task_node); // release task
+        detail::trace_schedule("serial", this);
+        metrics_.on_schedule(a_task_node);
+        queue_.push(&a_task_node); // release task
         const std::uint32_t prev_work = work_.fetch_add(1, std::memory_order::relaxed);
         if (prev_work == 0) {
             executor_.schedule(task_);
@@ -56,16 +94,12 @@ public:
 
     // TODO(@UsatiyNyan): dunno about that one yet, but seems like an ok algorithm
     void stop() noexcept override {
-        auto* head = batch_.extract(); // acquire task
-        DEBUG_ASSERT(head != nullptr);
-
-        auto* tail = meta::intrusive_forward_list_node_reverse(head);
-
         std::uint32_t batch_size = 0;
-        meta::intrusive_forward_list_node_for_each(tail, [&batch_size](task_node* a_task_node) {
+        while (node_type* current = pop_counted(batch_size)) {
             ++batch_size;
-            a_task_node->cancel();
-        });
+            metrics_.on_cancel();
+            current->downcast()->cancel();
+        }
 
         const std::uint32_t work_before_batch = work_.fetch_sub(batch_size, std::memory_order::relaxed);
         if (work_before_batch > batch_size) {
@@ -73,13 +107,60 @@ public:
         }
     }
 
+    // one task at a time, that's the point
+    constexpr std::size_t concurrency_hint() const noexcept override { return 1; }
+
     constexpr executor& get_inner() const { return executor_; }
 
+    // zeroed unless built w/ SL_EXEC_METRICS
+    executor_metrics_snapshot metrics() const { return metrics_.snapshot(); }
+
+    // counters are written by the running strand only, so the snapshot is not necessarily consistent
+    serial_executor_stats stats() const {
+        return serial_executor_stats{
+            .queue_depth = work_.load(std::memory_order::relaxed),
+            .runs = runs_.load(std::memory_order::relaxed),
+            .executed = executed_.load(std::memory_order::relaxed),
+            .yields = yields_.load(std::memory_order::relaxed),
+        };
+    }
+
+private:
+    // pops a task if there is one accounted in work_ beyond the already popped ones,
+    // those were fully pushed, so waiting for them only means waiting for some producer in the middle of a push
+    node_type* pop_counted(std::uint32_t popped) {
+        while (true) {
+            if (node_type* node = queue_.try_pop()) { // acquire task
+                return node;
+            }
+            if (work_.load(std::memory_order::relaxed) <= popped) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void record_run(std::uint32_t batch_size, bool yielded) {
+        runs_.store(runs_.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+        executed_.store(executed_.load(std::memory_order::relaxed) + batch_size, std::memory_order::relaxed);
+        if (yielded) {
+            yields_.store(yields_.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+        }
+    }
+
 private:
     serial_executor_task task_;
-    alignas(detail::hardware_destructive_interference_size) detail::lock_free_stack<task_node, Atomic> batch_;
+    detail::mpsc_queue<task_node, Atomic> queue_;
     alignas(detail::hardware_destructive_interference_size) Atomic<std::uint32_t> work_{ 0 };
     executor& executor_;
+    serial_executor_budget budget_;
+
+    // written by the running strand only
+    alignas(detail::hardware_destructive_interference_size) Atomic<std::uint64_t> runs_{ 0 };
+    Atomic<std::uint64_t> executed_{ 0 };
+    Atomic<std::uint64_t> yields_{ 0 };
+
+    [[no_unique_address]] detail::executor_metrics<Atomic> metrics_;
 };
 
 } // namespace sl::exec
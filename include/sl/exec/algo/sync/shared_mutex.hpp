@@ -0,0 +1,221 @@
+//
+// Created by usatiynyan.
+//
+// Lock state is owned by a serial_executor strand, so acquisition and release are plain (non-atomic) bookkeeping.
+// Readers never barge past a waiting writer, and a released writer admits the whole batch of readers that queued
+// behind it in a single strand run, so neither side starves.
+//
+
+#pragma once
+
+#include "sl/exec/algo/sched/on.hpp"
+#include "sl/exec/algo/sync/serial.hpp"
+#include "sl/exec/model/concept.hpp"
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include <sl/meta/assert.hpp>
+#include <sl/meta/traits/unique.hpp>
+
+#include <cstdint>
+#include <utility>
+
+namespace sl::exec {
+
+enum class shared_mutex_mode : std::uint8_t {
+    exclusive,
+    shared,
+};
+
+namespace detail {
+
+struct shared_mutex_waiter : task_node {
+    virtual void grant() noexcept = 0;
+};
+
+template <template <typename> typename Atomic>
+struct shared_mutex_impl final {
+    constexpr explicit shared_mutex_impl(executor& executor) : strand_{ executor } {}
+
+    // strand only
+    void acquire(shared_mutex_mode mode, shared_mutex_waiter& waiter) {
+        if (mode == shared_mutex_mode::shared) {
+            if (!has_writer_ && waiting_writers_.empty()) {
+                ++readers_;
+                waiter.grant();
+            } else {
+                waiting_readers_.push_back(&waiter);
+            }
+        } else {
+            if (!has_writer_ && readers_ == 0) {
+                has_writer_ = true;
+                waiter.grant();
+            } else {
+                waiting_writers_.push_back(&waiter);
+            }
+        }
+    }
+
+    // strand only
+    void release(shared_mutex_mode mode) {
+        if (mode == shared_mutex_mode::shared) {
+            DEBUG_ASSERT(readers_ > 0 && !has_writer_);
+            if (--readers_ == 0) {
+                grant_writer();
+            }
+            return;
+        }
+
+        DEBUG_ASSERT(has_writer_ && readers_ == 0);
+        has_writer_ = false;
+        if (!waiting_readers_.empty()) {
+            grant_readers();
+        } else {
+            grant_writer();
+        }
+    }
+
+    serial_executor<Atomic>& get_strand() { return strand_; }
+    executor& get_inner() const { return strand_.get_inner(); }
+
+private:
+    void grant_writer() {
+        if (task_node* writer = waiting_writers_.pop_front()) {
+            has_writer_ = true;
+            static_cast<shared_mutex_waiter*>(writer)->grant();
+        }
+    }
+
+    // the whole queue is admitted within a single strand run, so N readers resume after one scheduling round
+    void grant_readers() {
+        task_list batch = std::move(waiting_readers_);
+        readers_ += static_cast<std::uint32_t>(batch.size());
+        while (task_node* reader = batch.pop_front()) {
+            static_cast<shared_mutex_waiter*>(reader)->grant();
+        }
+    }
+
+private:
+    serial_executor<Atomic> strand_;
+    std::uint32_t readers_ = 0;
+    bool has_writer_ = false;
+    task_list waiting_writers_{};
+    task_list waiting_readers_{};
+};
+
+template <template <typename> typename Atomic, shared_mutex_mode Mode>
+struct [[nodiscard]] shared_mutex_unlock_signal final {
+    using value_type = meta::unit;
+    using error_type = meta::undefined;
+
+    template <typename SlotCtorT>
+    struct [[nodiscard]] connection_type final : task_node {
+        connection_type(SlotCtorT&& slot_ctor, shared_mutex_impl<Atomic>& impl)
+            : slot_{ std::move(slot_ctor)() }, impl_{ impl } {}
+
+        CancelHandle auto emit() && noexcept {
+            impl_.get_strand().schedule(*this);
+            return dummy_cancel_handle{};
+        }
+
+        void execute() noexcept override {
+            impl_.release(Mode);
+            std::move(slot_).set_value(meta::unit{});
+        }
+        void cancel() noexcept override { std::move(slot_).set_null(); }
+
+    private:
+        SlotFrom<SlotCtorT> slot_;
+        shared_mutex_impl<Atomic>& impl_;
+    };
+
+    shared_mutex_impl<Atomic>& impl;
+    executor& ex;
+
+public:
+    template <SlotCtorFor<shared_mutex_unlock_signal> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return connection_type<SlotCtorT>{ std::move(slot_ctor), impl };
+    }
+
+    executor& get_executor() noexcept { return ex; }
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic, shared_mutex_mode Mode>
+struct [[nodiscard]] shared_mutex_lock final : meta::unique {
+    constexpr explicit shared_mutex_lock(detail::shared_mutex_impl<Atomic>& impl) : impl_{ impl } {}
+    shared_mutex_lock(shared_mutex_lock&& other) noexcept
+        : impl_{ other.impl_ }, is_locked_{ std::exchange(other.is_locked_, false) } {}
+    ~shared_mutex_lock() noexcept { ASSERT(!is_locked_); }
+
+    constexpr Signal<meta::unit, meta::undefined> auto unlock() && {
+        return std::move(*this).unlock_on(impl_.get_inner());
+    }
+    constexpr Signal<meta::unit, meta::undefined> auto unlock_on(executor& executor) && {
+        DEBUG_ASSERT(is_locked_);
+        is_locked_ = false;
+        return detail::shared_mutex_unlock_signal<Atomic, Mode>{ .impl = impl_, .ex = executor };
+    }
+
+private:
+    detail::shared_mutex_impl<Atomic>& impl_;
+    bool is_locked_ = true;
+};
+
+namespace detail {
+
+template <template <typename> typename Atomic, shared_mutex_mode Mode>
+struct [[nodiscard]] shared_mutex_lock_signal final {
+    using value_type = shared_mutex_lock<Atomic, Mode>;
+    using error_type = meta::undefined;
+
+    template <typename SlotCtorT>
+    struct [[nodiscard]] connection_type final : shared_mutex_waiter {
+        connection_type(SlotCtorT&& slot_ctor, shared_mutex_impl<Atomic>& impl)
+            : slot_{ std::move(slot_ctor)() }, impl_{ impl } {}
+
+        CancelHandle auto emit() && noexcept {
+            impl_.get_strand().schedule(*this);
+            return dummy_cancel_handle{};
+        }
+
+        void execute() noexcept override { impl_.acquire(Mode, *this); }
+        void cancel() noexcept override { std::move(slot_).set_null(); }
+        void grant() noexcept override { std::move(slot_).set_value(value_type{ impl_ }); }
+
+    private:
+        SlotFrom<SlotCtorT> slot_;
+        shared_mutex_impl<Atomic>& impl_;
+    };
+
+    shared_mutex_impl<Atomic>& impl;
+
+public:
+    template <SlotCtorFor<shared_mutex_lock_signal> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return connection_type<SlotCtorT>{ std::move(slot_ctor), impl };
+    }
+
+    // granted on the strand, the continuation is scheduled back to the underlying executor
+    executor& get_executor() noexcept { return impl.get_inner(); }
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic>
+struct [[nodiscard]] shared_mutex final {
+    constexpr explicit shared_mutex(executor& executor) : impl_{ executor } {}
+
+    constexpr Signal<shared_mutex_lock<Atomic, shared_mutex_mode::exclusive>, meta::undefined> auto lock() {
+        return detail::shared_mutex_lock_signal<Atomic, shared_mutex_mode::exclusive>{ .impl = impl_ };
+    }
+    constexpr Signal<shared_mutex_lock<Atomic, shared_mutex_mode::shared>, meta::undefined> auto lock_shared() {
+        return detail::shared_mutex_lock_signal<Atomic, shared_mutex_mode::shared>{ .impl = impl_ };
+    }
+
+private:
+    detail::shared_mutex_impl<Atomic> impl_;
+};
+
+} // namespace sl::exec
@@ -7,3 +7,6 @@
 #include "sl/exec/algo/tf/par/all.hpp"
 #include "sl/exec/algo/tf/par/any.hpp"
 #include "sl/exec/algo/tf/par/fork.hpp"
+#include "sl/exec/algo/tf/par/map_concurrent.hpp"
+#include "sl/exec/algo/tf/par/when_all.hpp"
+#include "sl/exec/algo/tf/par/when_any.hpp"
@@ -1,12 +1,14 @@
 //
 // Created by usatiynyan.
-// NOTE: `all(...)` on signals breaks propagation of `try_cancel()`
+// `try_cancel()` is propagated to every signal
 //
 
 #pragma once
 
 #include "sl/exec/algo/sync/detail/parallel.hpp"
+#include "sl/exec/algo/sync/serial.hpp"
 #include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/layout.hpp"
 #include "sl/exec/thread/detail/atomic.hpp"
 
 #include <sl/meta/assert.hpp>
@@ -73,14 +75,14 @@ private:
     }
 
 public:
-    all_connection(std::tuple<SignalTs...>&& signals, serial_executor<Atomic>& an_executor, SlotCtorT slot_ctor)
+    all_connection(std::tuple<SignalTs...>&& signals, SlotCtorT slot_ctor)
         : parallel_{ make_connections(*this, std::move(signals), std::make_index_sequence<N>()),
-                     an_executor,
                      all_delete_this{ this } },
           slot_{ std::move(slot_ctor)() } {}
 
 public: // connection
     CancelHandle auto emit() && noexcept { return std::move(parallel_).emit(); }
+    void release() noexcept { parallel_.release(); }
 
 private:
     template <std::size_t Index, typename ElementValueT>
@@ -104,30 +106,30 @@ private:
             std::move(slot_).set_value(std::move(result));
         }
 
-        parallel_.schedule_delete_this();
+        parallel_.release();
     }
 
     void set_error_impl(std::size_t index, ErrorT&& error) noexcept {
         if (!done_.exchange(true, std::memory_order::acq_rel)) {
             std::move(slot_).set_error(std::move(error));
-            parallel_.schedule_try_cancel_beside(index);
+            parallel_.request_cancel_beside(index);
         }
 
         const bool is_last = parallel_.increment_and_check();
         if (is_last) {
-            parallel_.schedule_delete_this();
+            parallel_.release();
         }
     }
 
     void set_null_impl(std::size_t index) noexcept {
         if (!done_.exchange(true, std::memory_order::acq_rel)) {
             std::move(slot_).set_null();
-            parallel_.schedule_try_cancel_beside(index);
+            parallel_.request_cancel_beside(index);
         }
 
         const bool is_last = parallel_.increment_and_check();
         if (is_last) {
-            parallel_.schedule_delete_this();
+            parallel_.release();
         }
     }
 
@@ -136,28 +138,14 @@ private:
     std::tuple<meta::maybe<typename SignalTs::value_type>...> maybe_results_{};
     slot_type slot_;
     alignas(hardware_destructive_interference_size) Atomic<bool> done_{ false };
-};
-
-template <
-    typename ValueT,
-    typename ErrorT,
-    template <typename> typename Atomic,
-    typename SlotCtorT,
-    SomeSignal... SignalTs>
-struct all_connection_box final {
-    using connection_type = all_connection<ValueT, ErrorT, Atomic, SlotCtorT, SignalTs...>;
 
 public:
-    all_connection_box(std::tuple<SignalTs...>&& signals, serial_executor<Atomic>& an_executor, SlotCtorT slot_ctor)
-        : connection_{ std::make_unique<connection_type>(std::move(signals), an_executor, std::move(slot_ctor)) } {}
-
-    CancelHandle auto emit() && noexcept {
-        auto& a_connection = *DEBUG_ASSERT_VAL(connection_.release());
-        return std::move(a_connection).emit();
-    }
-
-private:
-    std::unique_ptr<connection_type> connection_;
+    static constexpr std::string_view layout_name = "all_connection";
+    using layout_members = std::tuple<
+        parallel_connection_type,
+        std::tuple<meta::maybe<typename SignalTs::value_type>...>,
+        slot_type,
+        layout_aligned<Atomic<bool>, hardware_destructive_interference_size>>;
 };
 
 template <template <typename> typename Atomic, SomeSignal... SignalTs>
@@ -167,37 +155,44 @@ struct [[nodiscard]] all_signal final {
     using error_type = meta::type::head_t<typename SignalTs::error_type...>;
 
 public:
-    explicit all_signal(SignalTs&&... signals, serial_executor<Atomic>& an_executor)
+    explicit all_signal(SignalTs&&... signals, executor& an_executor)
         : signals_{ std::move(signals)... }, executor_{ an_executor } {}
 
     template <SlotCtor<value_type, error_type> SlotCtorT>
     constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
-        return all_connection_box<value_type, error_type, Atomic, SlotCtorT, SignalTs...>{
+        using connection_type = all_connection<value_type, error_type, Atomic, SlotCtorT, SignalTs...>;
+        return parallel_connection_box<connection_type>{
             std::move(signals_),
-            executor_,
             std::move(slot_ctor),
         };
     }
 
-    executor& get_executor() noexcept { return executor_.get_inner(); }
+    // the result is delivered inline by the signal that decides it, the continuation is scheduled onto this one
+    executor& get_executor() noexcept { return executor_; }
 
 private:
     std::tuple<SignalTs...> signals_;
-    serial_executor<Atomic>& executor_;
+    executor& executor_;
 };
 
 } // namespace detail
 
 template <template <typename> typename Atomic>
-constexpr auto all_(serial_executor<Atomic>& an_executor = detail::inline_serial_executor<Atomic>()) {
-    return [&]<SomeSignal... SignalTs>(SignalTs... signals) {
+constexpr auto all_(executor& an_executor = inline_executor()) {
+    return [&an_executor]<SomeSignal... SignalTs>(SignalTs... signals) {
         return detail::all_signal<Atomic, SignalTs...>{ std::move(signals)..., an_executor };
     };
 }
 
+// nothing is serialized on it anymore, the continuation goes to the underlying executor
+template <template <typename> typename Atomic>
+constexpr auto all_(serial_executor<Atomic>& an_executor) {
+    return all_<Atomic>(an_executor.get_inner());
+}
+
 template <SomeSignal... SignalTs>
 constexpr SomeSignal auto all(SignalTs... signals) {
-    return all_<detail::atomic>(detail::inline_serial_executor<detail::atomic>())(std::move(signals)...);
+    return all_<detail::atomic>()(std::move(signals)...);
 }
 
 } // namespace sl::exec
@@ -1,11 +1,12 @@
 //
 // Created by usatiynyan.
-// NOTE: `any(...)` on signals breaks propagation of `try_cancel()`
+// `try_cancel()` is propagated to every signal
 //
 
 #pragma once
 
 #include "sl/exec/algo/sync/detail/parallel.hpp"
+#include "sl/exec/algo/sync/serial.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/thread/detail/atomic.hpp"
 
@@ -59,27 +60,26 @@ private:
 public:
     any_connection(
         std::tuple<SignalTs...>&& signals,
-        serial_executor<Atomic>& an_executor,
         SlotCtorT slot_ctor
     )
         : parallel_{ make_connections(*this, std::move(signals), std::make_index_sequence<N>()),
-                     an_executor,
                      any_delete_this{ this } },
           slot_{ std::move(slot_ctor)() } {}
 
 public: // connection
     CancelHandle auto emit() && noexcept { return std::move(parallel_).emit(); }
+    void release() noexcept { parallel_.release(); }
 
 private: // set_...
     void set_value_impl(std::size_t index, ValueT&& value) noexcept {
         if (!done_.exchange(true, std::memory_order::acq_rel)) {
             std::move(slot_).set_value(std::move(value));
-            parallel_.schedule_try_cancel_beside(index);
+            parallel_.request_cancel_beside(index);
         }
 
         const bool is_last = parallel_.increment_and_check();
         if (is_last) {
-            parallel_.schedule_delete_this();
+            parallel_.release();
         }
     }
 
@@ -93,7 +93,7 @@ private: // set_...
             std::move(slot_).set_error(std::move(error));
         }
 
-        parallel_.schedule_delete_this();
+        parallel_.release();
     }
 
     void set_null_impl() noexcept {
@@ -106,7 +106,7 @@ private: // set_...
             std::move(slot_).set_null();
         }
 
-        parallel_.schedule_delete_this();
+        parallel_.release();
     }
 
 private:
@@ -115,27 +115,6 @@ private:
     alignas(hardware_destructive_interference_size) Atomic<bool> done_{ false };
 };
 
-template <typename ValueT, typename ErrorT, template <typename> typename Atomic, typename SlotCtorT, SomeSignal... SignalTs>
-struct any_connection_box final {
-    using connection_type = any_connection<ValueT, ErrorT, Atomic, SlotCtorT, SignalTs...>;
-
-public:
-    any_connection_box(
-        std::tuple<SignalTs...>&& signals,
-        serial_executor<Atomic>& an_executor,
-        SlotCtorT slot_ctor
-    )
-        : connection_{ std::make_unique<connection_type>(std::move(signals), an_executor, std::move(slot_ctor)) } {}
-
-    CancelHandle auto emit() && noexcept {
-        auto& a_connection = *DEBUG_ASSERT_VAL(connection_.release());
-        return std::move(a_connection).emit();
-    }
-
-private:
-    std::unique_ptr<connection_type> connection_;
-};
-
 template <template <typename> typename Atomic, SomeSignal... SignalTs>
     requires meta::type::are_same_v<typename SignalTs::value_type...>
              && meta::type::are_same_v<typename SignalTs::error_type...>
@@ -144,37 +123,44 @@ struct [[nodiscard]] any_signal final {
     using error_type = meta::type::head_t<typename SignalTs::error_type...>;
 
 public:
-    explicit any_signal(SignalTs&&... signals, serial_executor<Atomic>& an_executor)
+    explicit any_signal(SignalTs&&... signals, executor& an_executor)
         : signals_{ std::move(signals)... }, executor_{ an_executor } {}
 
     template <SlotCtor<value_type, error_type> SlotCtorT>
     constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
-        return any_connection_box<value_type, error_type, Atomic, SlotCtorT, SignalTs...>{
+        using connection_type = any_connection<value_type, error_type, Atomic, SlotCtorT, SignalTs...>;
+        return parallel_connection_box<connection_type>{
             std::move(signals_),
-            executor_,
             std::move(slot_ctor),
         };
     }
 
-    executor& get_executor() noexcept { return executor_.get_inner(); }
+    // the result is delivered inline by the signal that decides it, the continuation is scheduled onto this one
+    executor& get_executor() noexcept { return executor_; }
 
 private:
     std::tuple<SignalTs...> signals_;
-    serial_executor<Atomic>& executor_;
+    executor& executor_;
 };
 
 } // namespace detail
 
 template <template <typename> typename Atomic>
-constexpr auto any_(serial_executor<Atomic>& an_executor = detail::inline_serial_executor<Atomic>()) {
-    return [&]<SomeSignal... SignalTs>(SignalTs... signals) {
+constexpr auto any_(executor& an_executor = inline_executor()) {
+    return [&an_executor]<SomeSignal... SignalTs>(SignalTs... signals) {
         return detail::any_signal<Atomic, SignalTs...>{ std::move(signals)..., an_executor };
     };
 }
 
+// nothing is serialized on it anymore, the continuation goes to the underlying executor
+template <template <typename> typename Atomic>
+constexpr auto any_(serial_executor<Atomic>& an_executor) {
+    return any_<Atomic>(an_executor.get_inner());
+}
+
 template <SomeSignal... SignalTs>
 constexpr SomeSignal auto any(SignalTs... signals) {
-    return any_<detail::atomic>(detail::inline_serial_executor<detail::atomic>())(std::move(signals)...);
+    return any_<detail::atomic>()(std::move(signals)...);
 }
 
 } // namespace sl::exec
@@ -4,30 +4,186 @@
 // value_type and error_type have to be thread-safe copyable
 // auto [l_signal, r_signal] = signal | fork(); // this already calls .subscribe() on signal
 //
+// With a compile-time N the source connection, the result and a fixed subscriber table live in one allocation,
+// every subscriber connection is its own callback, so there are no per-subscriber allocations or list traversals.
+//
 
 #pragma once
 
 #include "sl/exec/algo/emit/share.hpp"
 
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
 namespace sl::exec {
 namespace detail {
 
+template <SomeSignal SignalT, std::uint32_t N, template <typename> typename Atomic>
+struct [[nodiscard]] fork_storage final {
+    using value_type = typename SignalT::value_type;
+    using error_type = typename SignalT::error_type;
+    using result_type = meta::result<value_type, error_type>;
+    using callback_type = share_callback<value_type, error_type>;
+
+    enum state : std::uintptr_t {
+        state_empty = std::numeric_limits<std::uintptr_t>::min(),
+        state_result = std::numeric_limits<std::uintptr_t>::max(),
+    };
+
+    struct slot {
+        void set_value(value_type&& value) && noexcept {
+            self.set_result(result_type{ meta::ok_tag, std::move(value) });
+        }
+        void set_error(error_type&& error) && noexcept {
+            self.set_result(result_type{ meta::err_tag, std::move(error) });
+        }
+        void set_null() && noexcept { self.set_result(meta::null); }
+
+    public:
+        fork_storage& self;
+    };
+
+    struct slot_ctor {
+        constexpr slot operator()() && noexcept { return slot{ self }; }
+
+    public:
+        fork_storage& self;
+    };
+
+public:
+    // every signal holds a reference
+    explicit fork_storage(SignalT&& signal) : connection_{ std::move(signal).subscribe(slot_ctor{ *this }) } {}
+
+    void decref() & noexcept {
+        if (refcount_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    // lazy, the first subscriber to emit starts the source
+    // the subscriber's own reference keeps the storage alive until its callback is either published or invoked
+    void emit(std::uint32_t index, callback_type& a_callback) & noexcept {
+        if (!is_emitted_.exchange(true, std::memory_order::acq_rel)) {
+            std::ignore = std::move(connection_).emit();
+        }
+
+        std::uintptr_t curr_state = state_empty;
+        if (states_[index].compare_exchange_strong(
+                curr_state, std::bit_cast<std::uintptr_t>(&a_callback), std::memory_order::acq_rel
+            )) {
+            return;
+        }
+        DEBUG_ASSERT(curr_state == state_result);
+        // explicit copy, unfortunately
+        std::move(a_callback)(meta::maybe<result_type>{ maybe_result_ });
+        decref();
+    }
+
+private:
+    void set_result(meta::maybe<result_type> maybe_result) & noexcept {
+        maybe_result_ = std::move(maybe_result);
+
+        // decref-s are deferred, so that the storage outlives the whole table walk
+        std::uint32_t callback_count = 0;
+        for (auto& a_state : states_) {
+            const std::uintptr_t prev_state = a_state.exchange(state_result, std::memory_order::acq_rel);
+            if (prev_state == state_empty) {
+                continue;
+            }
+            // explicit copy, unfortunately
+            std::move(*std::bit_cast<callback_type*>(prev_state))(meta::maybe<result_type>{ maybe_result_ });
+            ++callback_count;
+        }
+        for (std::uint32_t i = 0; i != callback_count; ++i) {
+            decref();
+        }
+    }
+
+private:
+    ConnectionFor<SignalT, slot_ctor> connection_;
+    meta::maybe<result_type> maybe_result_{};
+    std::array<Atomic<std::uintptr_t>, N> states_{};
+    Atomic<bool> is_emitted_{ false };
+    Atomic<std::uint32_t> refcount_{ N };
+};
+
+template <typename StorageT, typename SlotCtorT>
+struct [[nodiscard]] fork_connection final : StorageT::callback_type {
+    using result_type = typename StorageT::result_type;
+
+public:
+    constexpr fork_connection(SlotCtorT&& slot_ctor, StorageT* storage_ptr, std::uint32_t index)
+        : slot_{ std::move(slot_ctor)() }, storage_ptr_{ storage_ptr }, index_{ index } {
+        // implicitly not propagating cancel-s into original signal
+    }
+
+    ~fork_connection() override {
+        if (nullptr != storage_ptr_) {
+            storage_ptr_->decref();
+        }
+    }
+
+    CancelHandle auto emit() && noexcept {
+        auto* storage_ptr = std::exchange(storage_ptr_, nullptr);
+        DEBUG_ASSERT(nullptr != storage_ptr);
+        storage_ptr->emit(index_, *this);
+        return dummy_cancel_handle{};
+    }
+
+    void operator()(meta::maybe<result_type>&& maybe_result) && noexcept override {
+        fulfill_slot(std::move(slot_), std::move(maybe_result));
+    }
+
+private:
+    SlotFrom<SlotCtorT> slot_;
+    StorageT* storage_ptr_;
+    std::uint32_t index_;
+};
+
+template <typename StorageT>
+struct [[nodiscard]] fork_signal final : meta::finalizer<fork_signal<StorageT>> {
+    using value_type = typename StorageT::value_type;
+    using error_type = typename StorageT::error_type;
+
+public:
+    constexpr fork_signal(StorageT* storage_ptr, std::uint32_t index)
+        : meta::finalizer<fork_signal>{ [](fork_signal& self) {
+              if (nullptr != self.storage_ptr_) {
+                  self.storage_ptr_->decref();
+              }
+          } },
+          storage_ptr_{ storage_ptr }, index_{ index } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        auto* storage_ptr = std::exchange(storage_ptr_, nullptr);
+        DEBUG_ASSERT(nullptr != storage_ptr);
+        return fork_connection<StorageT, SlotCtorT>{ std::move(slot_ctor), storage_ptr, index_ };
+    }
+
+    executor& get_executor() & noexcept { return exec::inline_executor(); }
+
+private:
+    StorageT* storage_ptr_;
+    std::uint32_t index_;
+};
+
 template <std::uint32_t N, template <typename> typename Atomic>
 struct [[nodiscard]] fork final {
     template <SomeSignal SignalT>
     constexpr auto operator()(SignalT&& signal) && {
-        using value_type = typename SignalT::value_type;
-        using error_type = typename SignalT::error_type;
-        share_box<value_type, error_type> shared{ std::move(signal) };
-        return make_signals(shared, std::make_integer_sequence<std::uint32_t, N>());
+        using storage_type = fork_storage<SignalT, N, Atomic>;
+        auto* storage_ptr = new storage_type{ std::move(signal) };
+        return make_signals(storage_ptr, std::make_integer_sequence<std::uint32_t, N>());
     }
 
 private:
-    template <typename ValueT, typename ErrorT, std::uint32_t... Idxs>
-    static constexpr auto
-        make_signals(share_box<ValueT, ErrorT>& shared, std::integer_sequence<std::uint32_t, Idxs...>) {
-        using signal_type = detail::share_signal<ValueT, ErrorT, Atomic>;
-        return std::array<signal_type, N>{ ((void)Idxs, shared.get_signal())... };
+    template <typename StorageT, std::uint32_t... Idxs>
+    static constexpr auto make_signals(StorageT* storage_ptr, std::integer_sequence<std::uint32_t, Idxs...>) {
+        return std::array<fork_signal<StorageT>, N>{ fork_signal<StorageT>{ storage_ptr, Idxs }... };
     }
 };
 
@@ -0,0 +1,344 @@
+//
+// Created by usatiynyan.
+// Runs `f(item)` over a range with at most `limit` child signals in flight, the next item is launched as soon as
+// one of them completes. Values are gathered in the original order, the first error (or null) is delivered eagerly,
+// stops launching and cancels the rest. `try_cancel()` stops launching and cancels the rest too, then delivers null.
+//
+// Every in-flight child has its own lane, completed lanes are handed back through an MPSC queue
+// and relaunched by a single drainer (whoever makes the queue non-empty), so there's no recursion
+// when children complete inline and no executor hop per item.
+//
+// The range is taken via `std::views::all`: lvalues are referenced and have to outlive the signal, rvalues are owned.
+//
+
+#pragma once
+
+#include "sl/exec/algo/sync/detail/parallel.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/mpsc_queue.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/func/lazy_eval.hpp>
+#include <sl/meta/intrusive/forward_list.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/type/unit.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+template <typename RangeT, typename F>
+using map_concurrent_signal_t = std::invoke_result_t<F&, std::ranges::range_reference_t<RangeT>>;
+
+template <typename RangeT, typename F, bool Collect, template <typename> typename Atomic, typename SlotCtorT>
+struct map_concurrent_connection final {
+    using signal_type = map_concurrent_signal_t<RangeT, F>;
+    using element_value_type = typename signal_type::value_type;
+    using value_type = std::conditional_t<Collect, std::vector<element_value_type>, meta::unit>;
+    using error_type = typename signal_type::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+private:
+    struct event_node : meta::intrusive_forward_list_node<event_node> {
+        std::size_t lane_index = 0;
+    };
+
+    struct lane_slot final {
+        map_concurrent_connection& self;
+        std::size_t lane_index;
+        std::size_t item_index;
+
+        void set_value(element_value_type&& value) && noexcept {
+            self.set_value_impl(lane_index, item_index, std::move(value));
+        }
+        void set_error(error_type&& error) && noexcept { self.set_error_impl(lane_index, std::move(error)); }
+        void set_null() && noexcept { self.set_null_impl(lane_index); }
+    };
+
+    struct lane_slot_ctor final {
+        map_concurrent_connection& self;
+        std::size_t lane_index;
+        std::size_t item_index;
+
+        constexpr lane_slot operator()() && noexcept { return lane_slot{ self, lane_index, item_index }; }
+    };
+
+    using child_connection_type = ConnectionFor<signal_type, lane_slot_ctor>;
+    using cancel_handle_type = decltype(std::declval<child_connection_type&&>().emit());
+
+    // only the drainer touches lanes
+    struct lane {
+        event_node node;
+        meta::maybe<child_connection_type> connection{};
+        meta::maybe<cancel_handle_type> cancel_handle{};
+    };
+
+public:
+    map_concurrent_connection(RangeT&& range, std::size_t limit, F&& f, SlotCtorT slot_ctor)
+        : range_{ std::move(range) }, next_{ std::ranges::begin(range_) },
+          size_{ static_cast<std::size_t>(std::ranges::distance(range_)) },
+          // zero would never launch anything, so is treated as one
+          lane_count_{ std::min(std::max<std::size_t>(limit, 1), size_) },
+          lanes_{ std::make_unique<lane[]>(lane_count_) }, f_{ std::move(f) }, slot_{ std::move(slot_ctor)() } {
+        if constexpr (Collect) {
+            results_.resize(size_);
+        }
+        for (std::size_t i = 0; i != lane_count_; ++i) {
+            lanes_[i].node.lane_index = i;
+        }
+        stop_node_.lane_index = lane_count_;
+    }
+
+public: // connection
+    CancelHandle auto emit() && noexcept {
+        if (lane_count_ == 0) {
+            finish();
+            release();
+            return proxy_cancel_handle{ this };
+        }
+
+        // every lane starts as a completed one
+        for (std::size_t i = 0; i != lane_count_; ++i) {
+            events_.push(&lanes_[i].node);
+        }
+        const auto count = static_cast<std::uint32_t>(lane_count_);
+        if (requests_.fetch_add(count, std::memory_order::acq_rel) == 0) {
+            drain(count);
+        }
+        // the owner holds its reference
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { request_stop(); }
+
+    // called once after the result is delivered and once by the owner
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+private:
+    void set_value_impl(std::size_t lane_index, std::size_t item_index, element_value_type&& value) noexcept {
+        if constexpr (Collect) {
+            results_[item_index].emplace(std::move(value));
+        }
+        push_event(lanes_[lane_index].node);
+    }
+
+    void set_error_impl(std::size_t lane_index, error_type&& error) noexcept {
+        if (!done_.exchange(true, std::memory_order::acq_rel)) {
+            std::move(slot_).set_error(std::move(error));
+            request_stop();
+        }
+        push_event(lanes_[lane_index].node);
+    }
+
+    void set_null_impl(std::size_t lane_index) noexcept {
+        if (!done_.exchange(true, std::memory_order::acq_rel)) {
+            std::move(slot_).set_null();
+            request_stop();
+        }
+        push_event(lanes_[lane_index].node);
+    }
+
+    void request_stop() noexcept {
+        if (!stop_requested_.exchange(true, std::memory_order::acq_rel)) {
+            push_event(stop_node_);
+        }
+    }
+
+    void push_event(event_node& node) noexcept {
+        events_.push(&node);
+        if (requests_.fetch_add(1, std::memory_order::acq_rel) == 0) {
+            drain(1);
+        }
+    }
+
+private: // drainer
+    void drain(std::uint32_t count) noexcept {
+        bool should_release = false;
+        while (true) {
+            for (std::uint32_t i = 0; i != count; ++i) {
+                handle(pop_counted());
+            }
+            // drainer state can't be touched after letting go of the queue
+            should_release |= is_finished_ && !std::exchange(is_released_, true);
+            const std::uint32_t prev = requests_.fetch_sub(count, std::memory_order::acq_rel);
+            if (prev == count) {
+                break;
+            }
+            count = prev - count;
+        }
+
+        // last, since it may delete `this`
+        if (should_release) {
+            release();
+        }
+    }
+
+    event_node& pop_counted() noexcept {
+        while (true) {
+            if (auto* node = events_.try_pop()) {
+                return *node->downcast();
+            }
+            // the event is accounted in requests_, so its producer is in the middle of a push
+            std::this_thread::yield();
+        }
+    }
+
+    void handle(event_node& node) noexcept {
+        if (node.lane_index == lane_count_) {
+            is_stopping_ = true;
+            for (std::size_t i = 0; i != lane_count_; ++i) {
+                if (lanes_[i].cancel_handle.has_value()) {
+                    std::move(*lanes_[i].cancel_handle).try_cancel();
+                }
+            }
+            return;
+        }
+
+        lane& a_lane = lanes_[node.lane_index];
+        a_lane.cancel_handle.reset();
+        a_lane.connection.reset();
+
+        if (!is_stopping_ && next_index_ != size_ && !done_.load(std::memory_order::acquire)) {
+            launch(node.lane_index);
+        } else if (++retired_count_ == lane_count_) {
+            finish();
+        }
+    }
+
+    void launch(std::size_t lane_index) noexcept {
+        lane& a_lane = lanes_[lane_index];
+        const std::size_t item_index = next_index_++;
+        auto& connection = a_lane.connection.emplace(meta::lazy_eval{ [&] {
+            return f_(*next_++).subscribe(lane_slot_ctor{ *this, lane_index, item_index });
+        } });
+        // even if the child has completed inline, its event is handled by this very drainer later on
+        a_lane.cancel_handle.emplace(std::move(connection).emit());
+    }
+
+    void finish() noexcept {
+        is_finished_ = true;
+        if (done_.exchange(true, std::memory_order::acq_rel)) {
+            return;
+        }
+        // cancelled from the outside, the children that couldn't be cancelled may have completed w/ values
+        if (is_stopping_ || next_index_ != size_) {
+            std::move(slot_).set_null();
+            return;
+        }
+        if constexpr (Collect) {
+            value_type result;
+            result.reserve(size_);
+            for (auto& maybe_value : results_) {
+                DEBUG_ASSERT(maybe_value.has_value());
+                result.push_back(std::move(maybe_value).value());
+            }
+            std::move(slot_).set_value(std::move(result));
+        } else {
+            std::move(slot_).set_value(meta::unit{});
+        }
+    }
+
+private:
+    RangeT range_;
+    std::ranges::iterator_t<RangeT> next_;
+    std::size_t size_;
+    std::size_t lane_count_;
+    std::unique_ptr<lane[]> lanes_;
+    F f_;
+    slot_type slot_;
+    // written by the children, read by the drainer that finishes
+    std::vector<meta::maybe<element_value_type>> results_{};
+    event_node stop_node_{};
+
+    // drainer state, synchronized via `requests_`
+    std::size_t next_index_ = 0;
+    std::size_t retired_count_ = 0;
+    bool is_stopping_ = false;
+    bool is_finished_ = false;
+    bool is_released_ = false;
+
+    mpsc_queue<event_node, Atomic> events_{};
+    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> requests_{ 0 };
+    Atomic<bool> done_{ false };
+    Atomic<bool> stop_requested_{ false };
+    // the completion and the owner
+    Atomic<std::uint32_t> refs_{ 2 };
+};
+
+template <typename RangeT, typename F, bool Collect, template <typename> typename Atomic>
+struct [[nodiscard]] map_concurrent_signal final {
+    using element_value_type = typename map_concurrent_signal_t<RangeT, F>::value_type;
+    using value_type = std::conditional_t<Collect, std::vector<element_value_type>, meta::unit>;
+    using error_type = typename map_concurrent_signal_t<RangeT, F>::error_type;
+
+public:
+    map_concurrent_signal(RangeT&& range, std::size_t limit, F&& f)
+        : range_{ std::move(range) }, limit_{ limit }, f_{ std::move(f) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        using connection_type = map_concurrent_connection<RangeT, F, Collect, Atomic, SlotCtorT>;
+        return parallel_connection_box<connection_type>{
+            std::move(range_),
+            limit_,
+            std::move(f_),
+            std::move(slot_ctor),
+        };
+    }
+
+    // the result is delivered inline by the child that decides it
+    executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    RangeT range_;
+    std::size_t limit_;
+    F f_;
+};
+
+} // namespace detail
+
+// `f(item)` has to return a signal, its values are gathered into a vector in the original order
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range RangeT,
+    typename F,
+    typename ViewT = std::views::all_t<RangeT>>
+    requires std::ranges::forward_range<ViewT> && SomeSignal<detail::map_concurrent_signal_t<ViewT, F>>
+constexpr SomeSignal auto map_concurrent(RangeT&& range, std::size_t limit, F f) {
+    return detail::map_concurrent_signal<ViewT, F, /*Collect=*/true, Atomic>{
+        std::views::all(std::forward<RangeT>(range)),
+        limit,
+        std::move(f),
+    };
+}
+
+// same as `map_concurrent`, but the values are dropped
+template <
+    template <typename> typename Atomic = detail::atomic,
+    std::ranges::viewable_range RangeT,
+    typename F,
+    typename ViewT = std::views::all_t<RangeT>>
+    requires std::ranges::forward_range<ViewT> && SomeSignal<detail::map_concurrent_signal_t<ViewT, F>>
+constexpr SomeSignal auto for_each_concurrent(RangeT&& range, std::size_t limit, F f) {
+    return detail::map_concurrent_signal<ViewT, F, /*Collect=*/false, Atomic>{
+        std::views::all(std::forward<RangeT>(range)),
+        limit,
+        std::move(f),
+    };
+}
+
+} // namespace sl::exec
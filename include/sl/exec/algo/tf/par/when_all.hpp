@@ -0,0 +1,192 @@
+//
+// Created by usatiynyan.
+// `all(...)` over a runtime range of homogeneous signals.
+// The first error (or null) is delivered eagerly and cancels the rest, values are gathered in the original order.
+// `try_cancel()` is propagated to every signal
+//
+
+#pragma once
+
+#include "sl/exec/algo/sync/detail/parallel_range.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/monad/maybe.hpp>
+
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+template <SomeSignal SignalT, template <typename> typename Atomic, typename SlotCtorT>
+struct when_all_connection final {
+    using element_value_type = typename SignalT::value_type;
+    using value_type = std::vector<element_value_type>;
+    using error_type = typename SignalT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+private:
+    struct when_all_slot final {
+        when_all_connection& self;
+        std::size_t index;
+
+        void set_value(element_value_type&& value) && noexcept { self.set_value_impl(index, std::move(value)); }
+        void set_error(error_type&& error) && noexcept { self.set_error_impl(index, std::move(error)); }
+        void set_null() && noexcept { self.set_null_impl(index); }
+    };
+
+    struct when_all_slot_ctor final {
+        when_all_connection& self;
+        std::size_t index;
+
+        constexpr when_all_slot operator()() && noexcept { return when_all_slot{ self, index }; }
+    };
+
+    using range_type = parallel_range<ConnectionFor<SignalT, when_all_slot_ctor>, element_value_type, Atomic>;
+
+public:
+    using block_type = parallel_range_block<when_all_connection, typename range_type::element>;
+
+    when_all_connection(std::vector<SignalT>&& signals, SlotCtorT slot_ctor)
+        : range_{ block_type::elements(this),
+                  std::move(signals),
+                  [this](std::size_t index) { return when_all_slot_ctor{ *this, index }; } },
+          slot_{ std::move(slot_ctor)() } {}
+
+public: // connection
+    CancelHandle auto emit() && noexcept {
+        // the owner holds its reference, so `this` is alive after finishing
+        if (range_.emit()) {
+            finish();
+        }
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { range_.request_cancel_all(); }
+
+    void release() noexcept {
+        if (range_.release_ref()) {
+            block_type::destroy(this);
+        }
+    }
+
+private:
+    void set_value_impl(std::size_t index, element_value_type&& value) noexcept {
+        range_.storage(index).emplace(std::move(value));
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void set_error_impl(std::size_t index, error_type&& error) noexcept {
+        if (!done_.exchange(true, std::memory_order::acq_rel)) {
+            std::move(slot_).set_error(std::move(error));
+            range_.request_cancel_beside(index);
+        }
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void set_null_impl(std::size_t index) noexcept {
+        if (!done_.exchange(true, std::memory_order::acq_rel)) {
+            std::move(slot_).set_null();
+            range_.request_cancel_beside(index);
+        }
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void finish() noexcept {
+        if (!done_.load(std::memory_order::relaxed)) {
+            value_type result;
+            result.reserve(range_.size());
+            for (std::size_t i = 0; i != range_.size(); ++i) {
+                auto& maybe_value = range_.storage(i);
+                DEBUG_ASSERT(maybe_value.has_value());
+                result.push_back(std::move(maybe_value).value());
+            }
+            std::move(slot_).set_value(std::move(result));
+        }
+        release();
+    }
+
+private:
+    range_type range_;
+    slot_type slot_;
+    Atomic<bool> done_{ false };
+};
+
+template <SomeSignal SignalT, template <typename> typename Atomic, typename SlotCtorT>
+struct when_all_connection_box final {
+    using connection_type = when_all_connection<SignalT, Atomic, SlotCtorT>;
+
+public:
+    when_all_connection_box(std::vector<SignalT>&& signals, SlotCtorT slot_ctor)
+        : connection_{
+              connection_type::block_type::create(signals.size(), std::move(signals), std::move(slot_ctor)),
+          } {}
+    when_all_connection_box(when_all_connection_box&& other) noexcept
+        : connection_{ std::exchange(other.connection_, nullptr) }, is_emitted_{ other.is_emitted_ } {}
+    ~when_all_connection_box() noexcept {
+        if (connection_ == nullptr) {
+            return;
+        }
+        if (is_emitted_) {
+            connection_->release();
+        } else {
+            connection_type::block_type::destroy(connection_);
+        }
+    }
+
+    CancelHandle auto emit() && noexcept {
+        DEBUG_ASSERT(connection_ != nullptr && !is_emitted_);
+        is_emitted_ = true;
+        return std::move(*connection_).emit();
+    }
+
+private:
+    connection_type* connection_;
+    bool is_emitted_ = false;
+};
+
+template <SomeSignal SignalT, template <typename> typename Atomic>
+struct [[nodiscard]] when_all_signal final {
+    using value_type = std::vector<typename SignalT::value_type>;
+    using error_type = typename SignalT::error_type;
+
+public:
+    explicit when_all_signal(std::vector<SignalT>&& signals) : signals_{ std::move(signals) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return when_all_connection_box<SignalT, Atomic, SlotCtorT>{ std::move(signals_), std::move(slot_ctor) };
+    }
+
+    // the result is delivered from whichever element completes last
+    executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    std::vector<SignalT> signals_;
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic, SomeSignal SignalT>
+constexpr SomeSignal auto when_all(std::vector<SignalT> signals) {
+    return detail::when_all_signal<SignalT, Atomic>{ std::move(signals) };
+}
+
+// moves out of the given signals
+template <template <typename> typename Atomic = detail::atomic, SomeSignal SignalT>
+constexpr SomeSignal auto when_all(std::span<SignalT> signals) {
+    return when_all<Atomic>(std::vector<SignalT>{ std::make_move_iterator(signals.begin()),
+                                                  std::make_move_iterator(signals.end()) });
+}
+
+} // namespace sl::exec
@@ -0,0 +1,190 @@
+//
+// Created by usatiynyan.
+// `any(...)` over a runtime range of homogeneous signals.
+// The first value is delivered eagerly and cancels the rest.
+// Otherwise the error of the lowest index is delivered, null if all of them are null or the range is empty.
+// `try_cancel()` is propagated to every signal
+//
+
+#pragma once
+
+#include "sl/exec/algo/sync/detail/parallel_range.hpp"
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/assert.hpp>
+
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sl::exec {
+namespace detail {
+
+template <SomeSignal SignalT, template <typename> typename Atomic, typename SlotCtorT>
+struct when_any_connection final {
+    using value_type = typename SignalT::value_type;
+    using error_type = typename SignalT::error_type;
+    using slot_type = SlotFrom<SlotCtorT>;
+
+private:
+    struct when_any_slot final {
+        when_any_connection& self;
+        std::size_t index;
+
+        void set_value(value_type&& value) && noexcept { self.set_value_impl(index, std::move(value)); }
+        void set_error(error_type&& error) && noexcept { self.set_error_impl(index, std::move(error)); }
+        void set_null() && noexcept { self.set_null_impl(index); }
+    };
+
+    struct when_any_slot_ctor final {
+        when_any_connection& self;
+        std::size_t index;
+
+        constexpr when_any_slot operator()() && noexcept { return when_any_slot{ self, index }; }
+    };
+
+    using range_type = parallel_range<ConnectionFor<SignalT, when_any_slot_ctor>, error_type, Atomic>;
+
+public:
+    using block_type = parallel_range_block<when_any_connection, typename range_type::element>;
+
+    when_any_connection(std::vector<SignalT>&& signals, SlotCtorT slot_ctor)
+        : range_{ block_type::elements(this),
+                  std::move(signals),
+                  [this](std::size_t index) { return when_any_slot_ctor{ *this, index }; } },
+          slot_{ std::move(slot_ctor)() } {}
+
+public: // connection
+    CancelHandle auto emit() && noexcept {
+        // the owner holds its reference, so `this` is alive after finishing
+        if (range_.emit()) {
+            finish();
+        }
+        return proxy_cancel_handle{ this };
+    }
+    void try_cancel() && noexcept { range_.request_cancel_all(); }
+
+    void release() noexcept {
+        if (range_.release_ref()) {
+            block_type::destroy(this);
+        }
+    }
+
+private:
+    void set_value_impl(std::size_t index, value_type&& value) noexcept {
+        if (!done_.exchange(true, std::memory_order::acq_rel)) {
+            std::move(slot_).set_value(std::move(value));
+            range_.request_cancel_beside(index);
+        }
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void set_error_impl(std::size_t index, error_type&& error) noexcept {
+        range_.storage(index).emplace(std::move(error));
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void set_null_impl(std::size_t) noexcept {
+        if (range_.release()) {
+            finish();
+        }
+    }
+
+    void finish() noexcept {
+        if (!done_.load(std::memory_order::relaxed)) {
+            finish_unresolved();
+        }
+        release();
+    }
+
+    void finish_unresolved() noexcept {
+        for (std::size_t i = 0; i != range_.size(); ++i) {
+            if (auto& maybe_error = range_.storage(i); maybe_error.has_value()) {
+                std::move(slot_).set_error(std::move(maybe_error).value());
+                return;
+            }
+        }
+        std::move(slot_).set_null();
+    }
+
+private:
+    range_type range_;
+    slot_type slot_;
+    Atomic<bool> done_{ false };
+};
+
+template <SomeSignal SignalT, template <typename> typename Atomic, typename SlotCtorT>
+struct when_any_connection_box final {
+    using connection_type = when_any_connection<SignalT, Atomic, SlotCtorT>;
+
+public:
+    when_any_connection_box(std::vector<SignalT>&& signals, SlotCtorT slot_ctor)
+        : connection_{
+              connection_type::block_type::create(signals.size(), std::move(signals), std::move(slot_ctor)),
+          } {}
+    when_any_connection_box(when_any_connection_box&& other) noexcept
+        : connection_{ std::exchange(other.connection_, nullptr) }, is_emitted_{ other.is_emitted_ } {}
+    ~when_any_connection_box() noexcept {
+        if (connection_ == nullptr) {
+            return;
+        }
+        if (is_emitted_) {
+            connection_->release();
+        } else {
+            connection_type::block_type::destroy(connection_);
+        }
+    }
+
+    CancelHandle auto emit() && noexcept {
+        DEBUG_ASSERT(connection_ != nullptr && !is_emitted_);
+        is_emitted_ = true;
+        return std::move(*connection_).emit();
+    }
+
+private:
+    connection_type* connection_;
+    bool is_emitted_ = false;
+};
+
+template <SomeSignal SignalT, template <typename> typename Atomic>
+struct [[nodiscard]] when_any_signal final {
+    using value_type = typename SignalT::value_type;
+    using error_type = typename SignalT::error_type;
+
+public:
+    explicit when_any_signal(std::vector<SignalT>&& signals) : signals_{ std::move(signals) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return when_any_connection_box<SignalT, Atomic, SlotCtorT>{ std::move(signals_), std::move(slot_ctor) };
+    }
+
+    // the result is delivered from either the first value or the last completed element
+    executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    std::vector<SignalT> signals_;
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic, SomeSignal SignalT>
+constexpr SomeSignal auto when_any(std::vector<SignalT> signals) {
+    return detail::when_any_signal<SignalT, Atomic>{ std::move(signals) };
+}
+
+// moves out of the given signals
+template <template <typename> typename Atomic = detail::atomic, SomeSignal SignalT>
+constexpr SomeSignal auto when_any(std::span<SignalT> signals) {
+    return when_any<Atomic>(std::vector<SignalT>{ std::make_move_iterator(signals.begin()),
+                                                  std::make_move_iterator(signals.end()) });
+}
+
+} // namespace sl::exec
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include "sl/exec/algo/tf/seq/detail/fused.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 
 #include <sl/meta/assert.hpp>
 #include <sl/meta/monad/maybe.hpp>
@@ -35,19 +37,59 @@ struct [[nodiscard]] and_then_slot final {
         and_then_slot& self_;
     };
 
-    F functor_;
-    SlotT slot_;
     executor& executor_;
-    meta::maybe<InputValueT> maybe_value_{};
     meta::maybe<and_then_task> maybe_task_{};
+    [[no_unique_address]] SlotT slot_;
+    [[no_unique_address]] F functor_;
+    meta::maybe<InputValueT> maybe_value_{};
+
+    static constexpr std::string_view layout_name = "and_then_slot";
+    using layout_members = std::tuple<executor&, meta::maybe<and_then_task>, SlotT, F, meta::maybe<InputValueT>>;
 
     void set_value(InputValueT&& value) && noexcept {
+        detail::trace_slot("and_then", "set_value");
         maybe_value_.emplace(std::move(value));
         auto& task = maybe_task_.emplace(*this);
         executor_.schedule(task);
     }
-    void set_error(ErrorT&& error) && noexcept { std::move(slot_).set_error(std::move(error)); }
-    void set_null() && noexcept { std::move(slot_).set_null(); }
+    void set_error(ErrorT&& error) && noexcept {
+        detail::trace_slot("and_then", "set_error");
+        std::move(slot_).set_error(std::move(error));
+    }
+    void set_null() && noexcept {
+        detail::trace_slot("and_then", "set_null");
+        std::move(slot_).set_null();
+    }
+};
+
+// `and_then` as a part of `fused_signal`
+template <typename F>
+struct [[nodiscard]] and_then_stage final {
+    template <typename ValueT, typename ErrorT>
+        requires std::same_as<ErrorT, typename std::invoke_result_t<F, ValueT>::error_type>
+    using value_type = typename std::invoke_result_t<F, ValueT>::value_type;
+    template <typename ValueT, typename ErrorT>
+    using error_type = ErrorT;
+
+    static constexpr std::string_view trace_name = "and_then";
+    static constexpr bool is_value_handled = true;
+    static constexpr bool is_error_handled = false;
+
+    F functor;
+
+    template <typename ValueT, typename NextT>
+    void set_value(ValueT&& value, NextT& next) noexcept {
+        auto result = functor(std::move(value));
+        if (result.has_value()) {
+            next.set_value(std::move(result).value());
+        } else {
+            next.set_error(std::move(result).error());
+        }
+    }
+    template <typename ErrorT, typename NextT>
+    void set_error(ErrorT&& error, NextT& next) noexcept {
+        next.set_error(std::move(error));
+    }
 };
 
 template <SomeSignal SignalT, typename F, typename SlotCtorT, typename ResultT = std::invoke_result_t<F, typename SignalT::value_type>>
@@ -66,15 +108,18 @@ struct [[nodiscard]] and_then_connection final {
 
         constexpr and_then_slot_type operator()() && noexcept {
             return and_then_slot_type{
-                .functor_ = std::move(functor),
-                .slot_ = std::move(slot_ctor)(),
                 .executor_ = ex,
+                .slot_ = std::move(slot_ctor)(),
+                .functor_ = std::move(functor),
             };
         }
     };
 
     ConnectionFor<SignalT, and_then_slot_ctor> connection;
 
+    static constexpr std::string_view layout_name = "and_then_connection";
+    using layout_members = std::tuple<ConnectionFor<SignalT, and_then_slot_ctor>>;
+
     constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
 };
 
@@ -102,6 +147,13 @@ public:
 
     constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
 
+    constexpr SomeSignal auto into_fused() && noexcept {
+        return fused_signal<SignalT, and_then_stage<F>>{
+            std::move(signal_),
+            std::tuple<and_then_stage<F>>{ and_then_stage<F>{ std::move(functor_) } },
+        };
+    }
+
 private:
     SignalT signal_;
     F functor_;
@@ -113,7 +165,11 @@ struct [[nodiscard]] and_then final {
 
     template <SomeSignal SignalT>
     constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
-        return and_then_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        if constexpr (FusableSignal<SignalT>) {
+            return std::move(signal).into_fused().then(and_then_stage<F>{ std::move(functor_) });
+        } else {
+            return and_then_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        }
     }
 
 private:
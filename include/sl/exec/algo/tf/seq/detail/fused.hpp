@@ -0,0 +1,244 @@
+//
+// Created by usatiynyan.
+// Adjacent `map`, `map_error`, `and_then` and `or_else` are fused into a single slot.
+// These stages always run on the executor of the signal they are applied to, so a chain of them shares it:
+// the slot schedules a single task and passes the value through all of the stages inline.
+// The only state is the input and the task, instead of a slot, a `maybe` and a task per stage.
+// If no stage handles the incoming value (error), it's forwarded inline w/o scheduling, same as unfused.
+//
+// A stage is a functor wrapper that takes `set_value(value, next)` / `set_error(error, next)`
+// and calls either `next.set_value` or `next.set_error` exactly once.
+// Its `trace_name` is what the unfused counterpart traces as, the fused slot traces as e.g. "map|and_then".
+//
+
+#pragma once
+
+#include "sl/exec/model/concept.hpp"
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/monad/result.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace sl::exec::detail {
+
+template <typename ValueT, typename ErrorT, typename... StageTs>
+struct fused_result {
+    using value_type = ValueT;
+    using error_type = ErrorT;
+};
+
+template <typename ValueT, typename ErrorT, typename StageT, typename... StageTs>
+struct fused_result<ValueT, ErrorT, StageT, StageTs...>
+    : fused_result<
+          typename StageT::template value_type<ValueT, ErrorT>,
+          typename StageT::template error_type<ValueT, ErrorT>,
+          StageTs...> {};
+
+// names of the stages joined w/ '|', null-terminated for `trace_slot`
+template <typename... StageTs>
+struct fused_trace_name {
+    static constexpr auto storage = [] {
+        std::array<char, (StageTs::trace_name.size() + ... + 0) + sizeof...(StageTs) + 1> joined{};
+        std::size_t length = 0;
+        const auto append = [&joined, &length](std::string_view name) {
+            if (length != 0) {
+                joined[length++] = '|';
+            }
+            for (const char c : name) {
+                joined[length++] = c;
+            }
+        };
+        (append(StageTs::trace_name), ...);
+        return joined;
+    }();
+
+    static constexpr const char* value = storage.data();
+};
+
+template <typename InputValueT, typename InputErrorT, typename SlotT, typename... StageTs>
+struct [[nodiscard]] fused_slot final {
+    struct fused_task final : task_node {
+        explicit fused_task(fused_slot& self) : self_{ self } {}
+
+        void execute() noexcept override {
+            if (!ASSERT_VAL(self_.maybe_input_.has_value())) {
+                return;
+            }
+            auto& input = *self_.maybe_input_;
+            if (input.has_value()) {
+                self_.template pass_value<0>(std::move(input).value());
+            } else {
+                self_.template pass_error<0>(std::move(input).error());
+            }
+        }
+        void cancel() noexcept override { std::move(self_).set_null(); }
+
+    private:
+        fused_slot& self_;
+    };
+
+    // what a stage sees as its `next`
+    template <std::size_t Index>
+    struct cursor final {
+        fused_slot& self;
+
+        template <typename ValueT>
+        void set_value(ValueT&& value) noexcept {
+            self.template pass_value<Index>(std::move(value));
+        }
+        template <typename ErrorT>
+        void set_error(ErrorT&& error) noexcept {
+            self.template pass_error<Index>(std::move(error));
+        }
+    };
+
+    static constexpr bool is_value_handled = (StageTs::is_value_handled || ...);
+    static constexpr bool is_error_handled = (StageTs::is_error_handled || ...);
+    static constexpr const char* trace_name = fused_trace_name<StageTs...>::value;
+
+    executor& executor_;
+    meta::maybe<fused_task> maybe_task_{};
+    [[no_unique_address]] SlotT slot_;
+    [[no_unique_address]] std::tuple<StageTs...> stages_;
+    meta::maybe<meta::result<InputValueT, InputErrorT>> maybe_input_{};
+
+    static constexpr std::string_view layout_name = "fused_slot";
+    using layout_members = std::tuple<
+        executor&,
+        meta::maybe<fused_task>,
+        SlotT,
+        std::tuple<StageTs...>,
+        meta::maybe<meta::result<InputValueT, InputErrorT>>>;
+
+    void set_value(InputValueT&& value) && noexcept {
+        detail::trace_slot(trace_name, "set_value");
+        if constexpr (is_value_handled) {
+            maybe_input_.emplace(meta::ok_tag, std::move(value));
+            auto& task = maybe_task_.emplace(*this);
+            executor_.schedule(task);
+        } else {
+            std::move(slot_).set_value(std::move(value));
+        }
+    }
+    void set_error(InputErrorT&& error) && noexcept {
+        detail::trace_slot(trace_name, "set_error");
+        if constexpr (is_error_handled) {
+            maybe_input_.emplace(meta::err_tag, std::move(error));
+            auto& task = maybe_task_.emplace(*this);
+            executor_.schedule(task);
+        } else {
+            std::move(slot_).set_error(std::move(error));
+        }
+    }
+    void set_null() && noexcept {
+        detail::trace_slot(trace_name, "set_null");
+        std::move(slot_).set_null();
+    }
+
+private:
+    template <std::size_t Index, typename ValueT>
+    void pass_value(ValueT&& value) noexcept {
+        if constexpr (Index == sizeof...(StageTs)) {
+            std::move(slot_).set_value(std::move(value));
+        } else {
+            cursor<Index + 1> next{ *this };
+            std::get<Index>(stages_).set_value(std::move(value), next);
+        }
+    }
+
+    template <std::size_t Index, typename ErrorT>
+    void pass_error(ErrorT&& error) noexcept {
+        if constexpr (Index == sizeof...(StageTs)) {
+            std::move(slot_).set_error(std::move(error));
+        } else {
+            cursor<Index + 1> next{ *this };
+            std::get<Index>(stages_).set_error(std::move(error), next);
+        }
+    }
+};
+
+template <SomeSignal SignalT, typename SlotCtorT, typename... StageTs>
+struct [[nodiscard]] fused_connection final {
+    using input_value_type = typename SignalT::value_type;
+    using input_error_type = typename SignalT::error_type;
+    using SlotT = SlotFrom<SlotCtorT>;
+    using fused_slot_type = fused_slot<input_value_type, input_error_type, SlotT, StageTs...>;
+
+    struct fused_slot_ctor {
+        std::tuple<StageTs...> stages;
+        SlotCtorT slot_ctor;
+        executor& ex;
+
+        constexpr fused_slot_type operator()() && noexcept {
+            return fused_slot_type{
+                .executor_ = ex,
+                .slot_ = std::move(slot_ctor)(),
+                .stages_ = std::move(stages),
+            };
+        }
+    };
+
+    ConnectionFor<SignalT, fused_slot_ctor> connection;
+
+    static constexpr std::string_view layout_name = "fused_connection";
+    using layout_members = std::tuple<ConnectionFor<SignalT, fused_slot_ctor>>;
+
+    constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
+};
+
+template <SomeSignal SignalT, typename... StageTs>
+struct [[nodiscard]] fused_signal final {
+    using result_type = fused_result<typename SignalT::value_type, typename SignalT::error_type, StageTs...>;
+    using value_type = typename result_type::value_type;
+    using error_type = typename result_type::error_type;
+
+public:
+    constexpr fused_signal(SignalT&& signal, std::tuple<StageTs...>&& stages)
+        : signal_{ std::move(signal) }, stages_{ std::move(stages) } {}
+
+    template <SlotCtor<value_type, error_type> SlotCtorT>
+    constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        using ConnectionT = fused_connection<SignalT, SlotCtorT, StageTs...>;
+        using SlotCtorForSignal = typename ConnectionT::fused_slot_ctor;
+        executor& ex = signal_.get_executor();
+        return ConnectionT{
+            .connection = std::move(signal_).subscribe(SlotCtorForSignal{
+                .stages = std::move(stages_),
+                .slot_ctor = std::move(slot_ctor),
+                .ex = ex,
+            }),
+        };
+    }
+
+    constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
+
+    constexpr fused_signal into_fused() && noexcept { return std::move(*this); }
+
+    template <typename StageT>
+    constexpr SomeSignal auto then(StageT&& stage) && noexcept {
+        return fused_signal<SignalT, StageTs..., StageT>{
+            std::move(signal_),
+            std::tuple_cat(std::move(stages_), std::tuple<StageT>{ std::move(stage) }),
+        };
+    }
+
+private:
+    SignalT signal_;
+    std::tuple<StageTs...> stages_;
+};
+
+// `map_signal`, `map_error_signal`, `and_then_signal`, `or_else_signal` and `fused_signal` itself
+template <typename SignalT>
+concept FusableSignal = SomeSignal<SignalT> && requires(SignalT signal) {
+    { std::move(signal).into_fused() } noexcept -> SomeSignal;
+};
+
+} // namespace sl::exec::detail
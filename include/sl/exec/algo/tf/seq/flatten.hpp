@@ -1,74 +1,187 @@
 //
 // Created by usatiynyan.
-// `flatten()` breaks cancellation chain for a signal created dynamically
+// `try_cancel()` is forwarded to the signal and, once it's created, to the dynamically created one.
 //
 
 #pragma once
 
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
 
 #include <sl/meta/func/lazy_eval.hpp>
 #include <sl/meta/monad/maybe.hpp>
 
+#include <cstdint>
+#include <utility>
+
 namespace sl::exec {
 namespace detail {
 
-template <SomeSignal SignalValueT, typename SlotT>
-struct [[nodiscard]] flatten_slot final {
+// The inner connection is emitted from within the outer slot and may complete (destroying the whole chain) right away,
+// so its result is held back until the inner cancel handle is published.
+template <SomeSignal SignalValueT, typename SlotT, template <typename> typename Atomic>
+struct flatten_state final {
     using value_type = typename SignalValueT::value_type;
     using error_type = typename SignalValueT::error_type;
+    using result_type = meta::result<value_type, error_type>;
+
+private:
+    enum flag : std::uint32_t {
+        inner_emitted = 0b001,
+        inner_completed = 0b010,
+        cancel_requested = 0b100,
+    };
 
     struct inner_slot {
-        SlotT slot;
+        flatten_state& self;
 
-        void set_value(value_type&& v) && noexcept { std::move(slot).set_value(std::move(v)); }
-        void set_error(error_type&& e) && noexcept { std::move(slot).set_error(std::move(e)); }
-        void set_null() && noexcept { std::move(slot).set_null(); }
+        void set_value(value_type&& v) && noexcept { self.complete_inner(result_type{ meta::ok_tag, std::move(v) }); }
+        void set_error(error_type&& e) && noexcept { self.complete_inner(result_type{ meta::err_tag, std::move(e) }); }
+        void set_null() && noexcept { self.complete_inner(meta::null); }
     };
 
     struct inner_slot_ctor {
-        SlotT slot;
+        flatten_state& self;
 
-        constexpr inner_slot operator()() && noexcept { return inner_slot{ std::move(slot) }; }
+        constexpr inner_slot operator()() && noexcept { return inner_slot{ self }; }
     };
 
-    SlotT slot_;
-    meta::maybe<ConnectionFor<SignalValueT, inner_slot_ctor>> maybe_connection_{};
+    using inner_connection_type = ConnectionFor<SignalValueT, inner_slot_ctor>;
+    using inner_cancel_handle_type = decltype(std::declval<inner_connection_type&&>().emit());
 
-    void set_value(SignalValueT&& signal) && noexcept {
-        auto& conn = maybe_connection_.emplace(
-            meta::lazy_eval{ [&] { return std::move(signal).subscribe(inner_slot_ctor{ std::move(slot_) }); } }
+public:
+    explicit flatten_state(SlotT&& slot) : slot_{ std::move(slot) } {}
+
+    void emit_inner(SignalValueT&& signal) noexcept {
+        if (flags_.load(std::memory_order::acquire) & cancel_requested) {
+            std::move(slot_).set_null();
+            return;
+        }
+
+        auto& connection = inner_connection_.emplace(
+            meta::lazy_eval{ [&] { return std::move(signal).subscribe(inner_slot_ctor{ *this }); } }
         );
-        // need to ignore cancel_handle here, otherwise - race
-        std::ignore = std::move(conn).emit();
+        inner_cancel_handle_.emplace(std::move(connection).emit());
+
+        // a cancellation that came before the handle was published is carried out here
+        std::uint32_t flags = flags_.load(std::memory_order::acquire);
+        bool is_cancelled = false;
+        while (true) {
+            if ((flags & cancel_requested) && !std::exchange(is_cancelled, true)) {
+                std::move(*inner_cancel_handle_).try_cancel();
+            }
+            if (flags_.compare_exchange_weak(
+                    flags, flags | inner_emitted, std::memory_order::acq_rel, std::memory_order::acquire
+                )) {
+                break;
+            }
+        }
+
+        if (flags & inner_completed) {
+            fulfill_slot(std::move(slot_), std::move(maybe_result_));
+        }
+    }
+
+    SlotT& slot() noexcept { return slot_; }
+
+    // by the connection owner, at most once
+    void request_cancel() noexcept {
+        const std::uint32_t prev_flags = flags_.fetch_or(cancel_requested, std::memory_order::acq_rel);
+        if (!(prev_flags & cancel_requested) && (prev_flags & inner_emitted)) {
+            std::move(*inner_cancel_handle_).try_cancel();
+        }
+    }
+
+private:
+    void complete_inner(meta::maybe<result_type> maybe_result) noexcept {
+        if (flags_.load(std::memory_order::acquire) & inner_emitted) {
+            fulfill_slot(std::move(slot_), std::move(maybe_result));
+            return;
+        }
+
+        maybe_result_ = std::move(maybe_result);
+        const std::uint32_t prev_flags = flags_.fetch_or(inner_completed, std::memory_order::acq_rel);
+        if (prev_flags & inner_emitted) {
+            fulfill_slot(std::move(slot_), std::move(maybe_result_));
+        }
     }
-    void set_error(error_type&& error) && noexcept { std::move(slot_).set_error(std::move(error)); }
-    void set_null() && noexcept { std::move(slot_).set_null(); }
+
+private:
+    SlotT slot_;
+    meta::maybe<inner_connection_type> inner_connection_{};
+    meta::maybe<inner_cancel_handle_type> inner_cancel_handle_{};
+    meta::maybe<result_type> maybe_result_{};
+    Atomic<std::uint32_t> flags_{ 0 };
 };
 
-template <SomeSignal SignalT, typename SlotCtorT, SomeSignal SignalValueT = typename SignalT::value_type>
+template <CancelHandle OuterCancelHandleT, typename StateT>
+struct flatten_cancel_handle final {
+    void try_cancel() && noexcept {
+        // first, so that the inner signal is not created if the outer one is late to cancel
+        state->request_cancel();
+        std::move(outer).try_cancel();
+    }
+
+public:
+    OuterCancelHandleT outer;
+    StateT* state;
+};
+
+template <
+    SomeSignal SignalT,
+    typename SlotCtorT,
+    template <typename> typename Atomic,
+    SomeSignal SignalValueT = typename SignalT::value_type>
     requires std::same_as<typename SignalT::error_type, typename SignalValueT::error_type>
 struct [[nodiscard]] flatten_connection final {
     using value_type = typename SignalValueT::value_type;
     using error_type = typename SignalT::error_type;
-    using SlotT = SlotFrom<SlotCtorT>;
-    using flatten_slot_type = flatten_slot<SignalValueT, SlotT>;
+    using state_type = flatten_state<SignalValueT, SlotFrom<SlotCtorT>, Atomic>;
 
-    struct flatten_slot_ctor {
-        SlotCtorT slot_ctor;
+    struct flatten_slot {
+        state_type& state;
 
-        constexpr flatten_slot_type operator()() && noexcept {
-            return flatten_slot_type{ .slot_ = std::move(slot_ctor)() };
+        void set_value(SignalValueT&& signal) && noexcept {
+            detail::trace_slot("flatten", "set_value");
+            state.emit_inner(std::move(signal));
+        }
+        void set_error(error_type&& error) && noexcept {
+            detail::trace_slot("flatten", "set_error");
+            std::move(state.slot()).set_error(std::move(error));
         }
+        void set_null() && noexcept {
+            detail::trace_slot("flatten", "set_null");
+            std::move(state.slot()).set_null();
+        }
+    };
+
+    struct flatten_slot_ctor {
+        state_type& state;
+
+        constexpr flatten_slot operator()() && noexcept { return flatten_slot{ state }; }
     };
 
-    ConnectionFor<SignalT, flatten_slot_ctor> connection;
+public:
+    flatten_connection(SignalT&& signal, SlotCtorT&& slot_ctor)
+        : state_{ std::move(slot_ctor)() }, connection_{ std::move(signal).subscribe(flatten_slot_ctor{ state_ }) } {}
+
+    constexpr CancelHandle auto emit() && noexcept {
+        // can't touch `this` after emit, the handle is returned as is
+        auto* state = &state_;
+        using outer_cancel_handle_type = decltype(std::move(connection_).emit());
+        return flatten_cancel_handle<outer_cancel_handle_type, state_type>{
+            .outer = std::move(connection_).emit(),
+            .state = state,
+        };
+    }
 
-    constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
+private:
+    state_type state_;
+    ConnectionFor<SignalT, flatten_slot_ctor> connection_;
 };
 
-template <SomeSignal SignalT, SomeSignal SignalValueT = typename SignalT::value_type>
+template <SomeSignal SignalT, template <typename> typename Atomic, SomeSignal SignalValueT = typename SignalT::value_type>
     requires std::same_as<typename SignalT::error_type, typename SignalValueT::error_type>
 struct [[nodiscard]] flatten_signal final {
     using value_type = typename SignalValueT::value_type;
@@ -79,11 +192,7 @@ public:
 
     template <SlotCtor<value_type, error_type> SlotCtorT>
     constexpr Connection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
-        using ConnectionT = flatten_connection<SignalT, SlotCtorT>;
-        using SlotCtorForSignal = typename ConnectionT::flatten_slot_ctor;
-        return ConnectionT{
-            .connection = std::move(signal_).subscribe(SlotCtorForSignal{ std::move(slot_ctor) }),
-        };
+        return flatten_connection<SignalT, SlotCtorT, Atomic>{ std::move(signal_), std::move(slot_ctor) };
     }
 
     constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
@@ -92,15 +201,19 @@ private:
     SignalT signal_;
 };
 
+template <template <typename> typename Atomic>
 struct [[nodiscard]] flatten final {
     template <SomeSignal SignalT>
     constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
-        return flatten_signal<SignalT>{ std::move(signal) };
+        return flatten_signal<SignalT, Atomic>{ std::move(signal) };
     }
 };
 
 } // namespace detail
 
-constexpr auto flatten() noexcept { return detail::flatten{}; }
+template <template <typename> typename Atomic = detail::atomic>
+constexpr auto flatten() noexcept {
+    return detail::flatten<Atomic>{};
+}
 
 } // namespace sl::exec
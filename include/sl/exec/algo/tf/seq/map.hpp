@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include "sl/exec/algo/stream/map.hpp"
+#include "sl/exec/algo/tf/seq/detail/fused.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 
 #include <sl/meta/assert.hpp>
 #include <sl/meta/monad/maybe.hpp>
@@ -31,19 +34,54 @@ struct [[nodiscard]] map_slot final {
         map_slot& self_;
     };
 
-    F functor_;
-    SlotT slot_;
     executor& executor_;
-    meta::maybe<InputValueT> maybe_value_{};
     meta::maybe<map_task> maybe_task_{};
+    // `slot_` and `functor_` are often empty, so they may take no space at all
+    [[no_unique_address]] SlotT slot_;
+    [[no_unique_address]] F functor_;
+    meta::maybe<InputValueT> maybe_value_{};
+
+    static constexpr std::string_view layout_name = "map_slot";
+    using layout_members = std::tuple<executor&, meta::maybe<map_task>, SlotT, F, meta::maybe<InputValueT>>;
 
     void set_value(InputValueT&& value) && noexcept {
+        detail::trace_slot("map", "set_value");
         maybe_value_.emplace(std::move(value));
         auto& task = maybe_task_.emplace(*this);
         executor_.schedule(task);
     }
-    void set_error(ErrorT&& error) && noexcept { std::move(slot_).set_error(std::move(error)); }
-    void set_null() && noexcept { std::move(slot_).set_null(); }
+    void set_error(ErrorT&& error) && noexcept {
+        detail::trace_slot("map", "set_error");
+        std::move(slot_).set_error(std::move(error));
+    }
+    void set_null() && noexcept {
+        detail::trace_slot("map", "set_null");
+        std::move(slot_).set_null();
+    }
+};
+
+// `map` as a part of `fused_signal`
+template <typename F>
+struct [[nodiscard]] map_stage final {
+    template <typename ValueT, typename ErrorT>
+    using value_type = std::invoke_result_t<F, ValueT>;
+    template <typename ValueT, typename ErrorT>
+    using error_type = ErrorT;
+
+    static constexpr std::string_view trace_name = "map";
+    static constexpr bool is_value_handled = true;
+    static constexpr bool is_error_handled = false;
+
+    F functor;
+
+    template <typename ValueT, typename NextT>
+    void set_value(ValueT&& value, NextT& next) noexcept {
+        next.set_value(functor(std::move(value)));
+    }
+    template <typename ErrorT, typename NextT>
+    void set_error(ErrorT&& error, NextT& next) noexcept {
+        next.set_error(std::move(error));
+    }
 };
 
 template <SomeSignal SignalT, typename F, typename SlotCtorT>
@@ -61,15 +99,18 @@ struct [[nodiscard]] map_connection final {
 
         constexpr map_slot_type operator()() && noexcept {
             return map_slot_type{
-                .functor_ = std::move(functor),
-                .slot_ = std::move(slot_ctor)(),
                 .executor_ = ex,
+                .slot_ = std::move(slot_ctor)(),
+                .functor_ = std::move(functor),
             };
         }
     };
 
     ConnectionFor<SignalT, map_slot_ctor> connection;
 
+    static constexpr std::string_view layout_name = "map_connection";
+    using layout_members = std::tuple<ConnectionFor<SignalT, map_slot_ctor>>;
+
     constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
 };
 
@@ -96,6 +137,13 @@ public:
 
     constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
 
+    constexpr SomeSignal auto into_fused() && noexcept {
+        return fused_signal<SignalT, map_stage<F>>{
+            std::move(signal_),
+            std::tuple<map_stage<F>>{ map_stage<F>{ std::move(functor_) } },
+        };
+    }
+
 private:
     SignalT signal_;
     F functor_;
@@ -107,7 +155,16 @@ struct [[nodiscard]] map final {
 
     template <SomeSignal SignalT>
     constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
-        return map_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        if constexpr (FusableSignal<SignalT>) {
+            return std::move(signal).into_fused().then(map_stage<F>{ std::move(functor_) });
+        } else {
+            return map_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        }
+    }
+
+    template <SomeStream StreamT>
+    constexpr SomeStream auto operator()(StreamT&& stream) && noexcept {
+        return map_stream<StreamT, F>{ std::move(stream), std::move(functor_) };
     }
 
 private:
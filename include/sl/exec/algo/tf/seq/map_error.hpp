@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include "sl/exec/algo/tf/seq/detail/fused.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 
 #include <sl/meta/assert.hpp>
 #include <sl/meta/monad/maybe.hpp>
@@ -31,19 +33,53 @@ struct [[nodiscard]] map_error_slot final {
         map_error_slot& self_;
     };
 
-    F functor_;
-    SlotT slot_;
     executor& executor_;
-    meta::maybe<InputErrorT> maybe_error_{};
     meta::maybe<map_error_task> maybe_task_{};
+    [[no_unique_address]] SlotT slot_;
+    [[no_unique_address]] F functor_;
+    meta::maybe<InputErrorT> maybe_error_{};
 
-    void set_value(ValueT&& value) && noexcept { std::move(slot_).set_value(std::move(value)); }
+    static constexpr std::string_view layout_name = "map_error_slot";
+    using layout_members = std::tuple<executor&, meta::maybe<map_error_task>, SlotT, F, meta::maybe<InputErrorT>>;
+
+    void set_value(ValueT&& value) && noexcept {
+        detail::trace_slot("map_error", "set_value");
+        std::move(slot_).set_value(std::move(value));
+    }
     void set_error(InputErrorT&& error) && noexcept {
+        detail::trace_slot("map_error", "set_error");
         maybe_error_.emplace(std::move(error));
         auto& task = maybe_task_.emplace(*this);
         executor_.schedule(task);
     }
-    void set_null() && noexcept { std::move(slot_).set_null(); }
+    void set_null() && noexcept {
+        detail::trace_slot("map_error", "set_null");
+        std::move(slot_).set_null();
+    }
+};
+
+// `map_error` as a part of `fused_signal`
+template <typename F>
+struct [[nodiscard]] map_error_stage final {
+    template <typename ValueT, typename ErrorT>
+    using value_type = ValueT;
+    template <typename ValueT, typename ErrorT>
+    using error_type = std::invoke_result_t<F, ErrorT>;
+
+    static constexpr std::string_view trace_name = "map_error";
+    static constexpr bool is_value_handled = false;
+    static constexpr bool is_error_handled = true;
+
+    F functor;
+
+    template <typename ValueT, typename NextT>
+    void set_value(ValueT&& value, NextT& next) noexcept {
+        next.set_value(std::move(value));
+    }
+    template <typename ErrorT, typename NextT>
+    void set_error(ErrorT&& error, NextT& next) noexcept {
+        next.set_error(functor(std::move(error)));
+    }
 };
 
 template <SomeSignal SignalT, typename F, typename SlotCtorT>
@@ -61,15 +97,18 @@ struct [[nodiscard]] map_error_connection final {
 
         constexpr map_error_slot_type operator()() && noexcept {
             return map_error_slot_type{
-                .functor_ = std::move(functor),
-                .slot_ = std::move(slot_ctor)(),
                 .executor_ = ex,
+                .slot_ = std::move(slot_ctor)(),
+                .functor_ = std::move(functor),
             };
         }
     };
 
     ConnectionFor<SignalT, map_error_slot_ctor> connection;
 
+    static constexpr std::string_view layout_name = "map_error_connection";
+    using layout_members = std::tuple<ConnectionFor<SignalT, map_error_slot_ctor>>;
+
     constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
 };
 
@@ -96,6 +135,13 @@ public:
 
     constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
 
+    constexpr SomeSignal auto into_fused() && noexcept {
+        return fused_signal<SignalT, map_error_stage<F>>{
+            std::move(signal_),
+            std::tuple<map_error_stage<F>>{ map_error_stage<F>{ std::move(functor_) } },
+        };
+    }
+
 private:
     SignalT signal_;
     F functor_;
@@ -107,7 +153,11 @@ struct [[nodiscard]] map_error final {
 
     template <SomeSignal SignalT>
     constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
-        return map_error_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        if constexpr (FusableSignal<SignalT>) {
+            return std::move(signal).into_fused().then(map_error_stage<F>{ std::move(functor_) });
+        } else {
+            return map_error_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        }
     }
 
 private:
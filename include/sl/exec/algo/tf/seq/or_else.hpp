@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include "sl/exec/algo/tf/seq/detail/fused.hpp"
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 
 #include <sl/meta/assert.hpp>
 #include <sl/meta/monad/maybe.hpp>
@@ -35,19 +37,59 @@ struct [[nodiscard]] or_else_slot final {
         or_else_slot& self_;
     };
 
-    F functor_;
-    SlotT slot_;
     executor& executor_;
-    meta::maybe<InputErrorT> maybe_error_{};
     meta::maybe<or_else_task> maybe_task_{};
+    [[no_unique_address]] SlotT slot_;
+    [[no_unique_address]] F functor_;
+    meta::maybe<InputErrorT> maybe_error_{};
 
-    void set_value(ValueT&& value) && noexcept { std::move(slot_).set_value(std::move(value)); }
+    static constexpr std::string_view layout_name = "or_else_slot";
+    using layout_members = std::tuple<executor&, meta::maybe<or_else_task>, SlotT, F, meta::maybe<InputErrorT>>;
+
+    void set_value(ValueT&& value) && noexcept {
+        detail::trace_slot("or_else", "set_value");
+        std::move(slot_).set_value(std::move(value));
+    }
     void set_error(InputErrorT&& error) && noexcept {
+        detail::trace_slot("or_else", "set_error");
         maybe_error_.emplace(std::move(error));
         auto& task = maybe_task_.emplace(*this);
         executor_.schedule(task);
     }
-    void set_null() && noexcept { std::move(slot_).set_null(); }
+    void set_null() && noexcept {
+        detail::trace_slot("or_else", "set_null");
+        std::move(slot_).set_null();
+    }
+};
+
+// `or_else` as a part of `fused_signal`
+template <typename F>
+struct [[nodiscard]] or_else_stage final {
+    template <typename ValueT, typename ErrorT>
+        requires std::same_as<ValueT, typename std::invoke_result_t<F, ErrorT>::value_type>
+    using value_type = ValueT;
+    template <typename ValueT, typename ErrorT>
+    using error_type = typename std::invoke_result_t<F, ErrorT>::error_type;
+
+    static constexpr std::string_view trace_name = "or_else";
+    static constexpr bool is_value_handled = false;
+    static constexpr bool is_error_handled = true;
+
+    F functor;
+
+    template <typename ValueT, typename NextT>
+    void set_value(ValueT&& value, NextT& next) noexcept {
+        next.set_value(std::move(value));
+    }
+    template <typename ErrorT, typename NextT>
+    void set_error(ErrorT&& error, NextT& next) noexcept {
+        auto result = functor(std::move(error));
+        if (result.has_value()) {
+            next.set_value(std::move(result).value());
+        } else {
+            next.set_error(std::move(result).error());
+        }
+    }
 };
 
 template <SomeSignal SignalT, typename F, typename SlotCtorT, typename ResultT = std::invoke_result_t<F, typename SignalT::error_type>>
@@ -66,15 +108,18 @@ struct [[nodiscard]] or_else_connection final {
 
         constexpr or_else_slot_type operator()() && noexcept {
             return or_else_slot_type{
-                .functor_ = std::move(functor),
-                .slot_ = std::move(slot_ctor)(),
                 .executor_ = ex,
+                .slot_ = std::move(slot_ctor)(),
+                .functor_ = std::move(functor),
             };
         }
     };
 
     ConnectionFor<SignalT, or_else_slot_ctor> connection;
 
+    static constexpr std::string_view layout_name = "or_else_connection";
+    using layout_members = std::tuple<ConnectionFor<SignalT, or_else_slot_ctor>>;
+
     constexpr CancelHandle auto emit() && noexcept { return std::move(connection).emit(); }
 };
 
@@ -102,6 +147,13 @@ public:
 
     constexpr executor& get_executor() noexcept { return signal_.get_executor(); }
 
+    constexpr SomeSignal auto into_fused() && noexcept {
+        return fused_signal<SignalT, or_else_stage<F>>{
+            std::move(signal_),
+            std::tuple<or_else_stage<F>>{ or_else_stage<F>{ std::move(functor_) } },
+        };
+    }
+
 private:
     SignalT signal_;
     F functor_;
@@ -113,7 +165,11 @@ struct [[nodiscard]] or_else final {
 
     template <SomeSignal SignalT>
     constexpr SomeSignal auto operator()(SignalT&& signal) && noexcept {
-        return or_else_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        if constexpr (FusableSignal<SignalT>) {
+            return std::move(signal).into_fused().then(or_else_stage<F>{ std::move(functor_) });
+        } else {
+            return or_else_signal<SignalT, F>{ std::move(signal), std::move(functor_) };
+        }
     }
 
 private:
@@ -13,3 +13,4 @@
 #include "sl/exec/coro/as_signal.hpp"
 #include "sl/exec/coro/async_gen.hpp"
 #include "sl/exec/coro/await.hpp"
+#include "sl/exec/coro/stream.hpp"
@@ -8,6 +8,7 @@
 
 #include "sl/exec/model/concept.hpp"
 
+#include <sl/meta/func/lazy_eval.hpp>
 #include <sl/meta/monad/maybe.hpp>
 #include <sl/meta/monad/result.hpp>
 
@@ -74,9 +75,10 @@ public:
         DEBUG_ASSERT(std::holds_alternative<SignalT>(state_));
         auto signal = std::get<SignalT>(std::move(state_));
         auto& executor = signal.get_executor();
-        auto& a_connection = state_.template emplace<connection_type>(
-            std::move(signal).subscribe(slot_ctor_type{ std::move(handle), maybe_result_, executor })
-        );
+        // connections are not necessarily movable
+        auto& a_connection = state_.template emplace<connection_type>(meta::lazy_eval{ [&] {
+            return std::move(signal).subscribe(slot_ctor_type{ std::move(handle), maybe_result_, executor });
+        } });
         std::ignore = std::move(a_connection).emit();
     }
     meta::result<value_type, error_type> await_resume() {
@@ -0,0 +1,171 @@
+//
+// Created by usatiynyan.
+// `as_stream(async_gen)` - the values yielded by a generator, the generator is resumed once per requested value.
+// The return value is dropped, an exception ends the stream with `set_error`.
+//
+// The generator can only hand its values over to a coroutine, so there's a tiny one in between,
+// it suspends after every value and is resumed by the stream drainer.
+//
+
+#pragma once
+
+#include "sl/exec/algo/stream/detail/pump.hpp"
+#include "sl/exec/coro/async_gen.hpp"
+#include "sl/exec/model/stream.hpp"
+#include "sl/exec/thread/detail/atomic.hpp"
+
+#include <sl/meta/monad/maybe.hpp>
+#include <sl/meta/monad/result.hpp>
+#include <sl/meta/type/unit.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace sl::exec {
+namespace detail {
+
+struct [[nodiscard]] async_gen_pull final {
+    struct promise_type {
+        // vvv compiler hooks
+        async_gen_pull get_return_object() noexcept {
+            return async_gen_pull{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+        // ^^^ compiler hooks
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename YieldT, typename ReturnT, typename SlotCtorT, template <typename> typename Atomic>
+struct [[nodiscard]] async_gen_stream_connection final
+    : stream_pump<
+          async_gen_stream_connection<YieldT, ReturnT, SlotCtorT, Atomic>,
+          YieldT,
+          std::exception_ptr,
+          SlotFrom<SlotCtorT>,
+          Atomic> {
+    using base_type = stream_pump<async_gen_stream_connection, YieldT, std::exception_ptr, SlotFrom<SlotCtorT>, Atomic>;
+    using result_type = typename base_type::result_type;
+    // nothing on exhaustion
+    using pull_result_type = meta::result<meta::maybe<YieldT>, std::exception_ptr>;
+    friend base_type;
+
+private:
+    // publishes the pulled value once the coroutine is suspended, so that the drainer is free to resume it
+    struct pulled_awaiter {
+        async_gen_stream_connection& self;
+        pull_result_type result;
+
+        // vvv compiler hooks
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) noexcept {
+            // the coroutine may be resumed from within, the awaiter is not touched afterwards
+            self.complete_pull(std::move(result));
+        }
+        void await_resume() const noexcept {}
+        // ^^^ compiler hooks
+    };
+
+    static async_gen_pull make_pull(async_gen<YieldT, ReturnT>& gen, async_gen_stream_connection& self) {
+        while (true) {
+            meta::maybe<pull_result_type> maybe_result;
+            try {
+                maybe_result.emplace(meta::ok_tag, co_await gen);
+            } catch (...) {
+                maybe_result.emplace(meta::err_tag, std::current_exception());
+            }
+            co_await pulled_awaiter{ self, std::move(maybe_result).value() };
+        }
+    }
+
+public:
+    async_gen_stream_connection(async_gen<YieldT, ReturnT>&& gen, SlotCtorT&& slot_ctor)
+        : base_type{ std::move(slot_ctor)() }, gen_{ std::move(gen) }, pull_{ make_pull(gen_, *this) } {}
+
+    ~async_gen_stream_connection() noexcept { pull_.handle.destroy(); }
+
+public: // connection
+    void emit() noexcept {}
+
+private:
+    void complete_pull(pull_result_type&& result) noexcept {
+        maybe_pulled_.emplace(std::move(result));
+        is_pulled_.store(true, std::memory_order::release);
+        this->notify();
+    }
+
+    void pump() noexcept {
+        if (is_pulled_.exchange(false, std::memory_order::acquire)) {
+            pull_result_type result = std::move(maybe_pulled_).value();
+            maybe_pulled_.reset();
+            is_pulling_ = false;
+
+            if (!result.has_value()) {
+                this->finish(result_type{ meta::err_tag, std::move(result).error() });
+                return;
+            }
+            meta::maybe<YieldT> maybe_value = std::move(result).value();
+            if (!maybe_value.has_value()) {
+                this->finish(result_type{ meta::ok_tag, meta::unit{} });
+                return;
+            }
+            this->next(std::move(maybe_value).value());
+        }
+
+        // a running generator can't be interrupted, the cancellation waits for its value
+        if (is_pulling_) {
+            return;
+        }
+        if (this->is_cancel_requested()) {
+            this->finish(meta::null);
+            return;
+        }
+        if (this->demand() > 0) {
+            is_pulling_ = true;
+            // may yield inline, then it's picked up by the next round of this very drainer
+            pull_.handle.resume();
+        }
+    }
+
+private:
+    async_gen<YieldT, ReturnT> gen_;
+    async_gen_pull pull_;
+    // drainer state
+    bool is_pulling_ = false;
+    // written by the pull, read by the drainer
+    meta::maybe<pull_result_type> maybe_pulled_{};
+    Atomic<bool> is_pulled_{ false };
+};
+
+template <typename YieldT, typename ReturnT, template <typename> typename Atomic>
+struct [[nodiscard]] async_gen_stream final {
+    using value_type = YieldT;
+    using error_type = std::exception_ptr;
+
+public:
+    constexpr explicit async_gen_stream(async_gen<YieldT, ReturnT>&& gen) : gen_{ std::move(gen) } {}
+
+    template <StreamSlotCtor<value_type, error_type> SlotCtorT>
+    constexpr StreamConnection auto subscribe(SlotCtorT&& slot_ctor) && noexcept {
+        return async_gen_stream_connection<YieldT, ReturnT, SlotCtorT, Atomic>{ std::move(gen_), std::move(slot_ctor) };
+    }
+
+    static executor& get_executor() noexcept { return inline_executor(); }
+
+private:
+    async_gen<YieldT, ReturnT> gen_;
+};
+
+} // namespace detail
+
+template <template <typename> typename Atomic = detail::atomic, typename YieldT, typename ReturnT>
+constexpr SomeStream auto as_stream(async_gen<YieldT, ReturnT> gen) {
+    return detail::async_gen_stream<YieldT, ReturnT, Atomic>{ std::move(gen) };
+}
+
+} // namespace sl::exec
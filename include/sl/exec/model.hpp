@@ -7,6 +7,8 @@
 #include "sl/exec/model/concept.hpp"
 #include "sl/exec/model/connection.hpp"
 #include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/layout.hpp"
 #include "sl/exec/model/slot.hpp"
+#include "sl/exec/model/stream.hpp"
 #include "sl/exec/model/syntax.hpp"
 #include "sl/exec/model/task.hpp"
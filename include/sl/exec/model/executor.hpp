@@ -6,18 +6,28 @@
 
 #include "sl/exec/model/task.hpp"
 
+#include "sl/exec/thread/detail/trace.hpp"
+
+#include <cstddef>
+
 namespace sl::exec {
 
 struct executor {
     virtual ~executor() noexcept = default;
     virtual void schedule(task_node& a_task_node) noexcept = 0;
     virtual void stop() noexcept = 0;
+    // how many tasks may run at the same time, 0 if unknown
+    virtual std::size_t concurrency_hint() const noexcept { return 0; }
 };
 
 inline executor& inline_executor() {
     struct impl final : executor {
-        constexpr void schedule(task_node& a_task_node) noexcept override { a_task_node.execute(); }
+        void schedule(task_node& a_task_node) noexcept override {
+            detail::trace_execute_scope trace_scope{ "inline", this };
+            a_task_node.execute();
+        }
         constexpr void stop() noexcept override {}
+        constexpr std::size_t concurrency_hint() const noexcept override { return 1; }
     };
 
     static impl an_executor;
@@ -0,0 +1,232 @@
+//
+// Created by usatiynyan.
+// Compile-time size and layout report of connections, to see where the bytes of a deep pipeline go.
+//
+// A type opts in by declaring
+//  - `layout_name` - what it's reported as
+//  - `layout_members` - `std::tuple` of its member types in declaration order, references are pointer-sized,
+//    `alignas(N)` members are spelled as `layout_aligned<T, N>`,
+//    empty members are assumed to be `[[no_unique_address]]`
+//  - `layout_allocated` (optional) - `std::tuple` of types it puts into separate heap allocations
+// Described members (also the ones inside of `std::tuple`-s) and allocations are expanded recursively,
+// so a connection unfolds into its stages:
+// slots of the later stages are nested into the connection of the source.
+// Padding is what's left of `sizeof` after the members, including the padding at the tail.
+// The members are laid out as the compiler would, `layout_of` doesn't compile if that doesn't add up to `sizeof`.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace sl::exec {
+
+// marker for a member declared as `alignas(Alignment) T`
+template <typename T, std::size_t Alignment>
+struct layout_aligned;
+
+struct layout_entry final {
+    std::string_view name;
+    std::size_t depth = 0;
+    std::size_t size = 0;
+    std::size_t alignment = 0;
+    std::size_t padding = 0;
+    bool is_allocated = false;
+};
+
+template <typename T>
+concept LayoutDescribed = requires {
+    { T::layout_name } -> std::convertible_to<std::string_view>;
+    typename T::layout_members;
+};
+
+namespace detail {
+
+template <typename MemberT>
+struct is_layout_aligned : std::false_type {};
+
+template <typename T, std::size_t Alignment>
+struct is_layout_aligned<layout_aligned<T, Alignment>> : std::true_type {};
+
+template <typename MemberT>
+struct layout_member {
+    using type = MemberT;
+    static constexpr std::size_t alignment = alignof(MemberT);
+    static constexpr std::size_t size = sizeof(MemberT);
+};
+
+template <typename MemberT>
+    requires std::is_reference_v<MemberT>
+struct layout_member<MemberT> {
+    using type = MemberT;
+    static constexpr std::size_t alignment = alignof(void*);
+    static constexpr std::size_t size = sizeof(void*);
+};
+
+template <typename MemberT>
+    requires(!is_layout_aligned<MemberT>::value && std::is_empty_v<MemberT>)
+struct layout_member<MemberT> {
+    using type = MemberT;
+    static constexpr std::size_t alignment = alignof(MemberT);
+    // assuming `[[no_unique_address]]`
+    static constexpr std::size_t size = 0;
+};
+
+template <typename T, std::size_t Alignment>
+struct layout_member<layout_aligned<T, Alignment>> : layout_member<T> {
+    static constexpr std::size_t alignment = std::max(Alignment, layout_member<T>::alignment);
+};
+
+template <typename MemberT>
+using layout_member_t = typename layout_member<MemberT>::type;
+
+constexpr std::size_t layout_align_up(std::size_t offset, std::size_t alignment) noexcept {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <typename TupleT>
+struct layout_tuple;
+
+template <typename... Ts>
+struct layout_tuple<std::tuple<Ts...>> {
+    static constexpr std::size_t members_size = (layout_member<Ts>::size + ... + 0);
+
+    // empty members share the address of another subobject, so they only contribute their alignment
+    static constexpr std::size_t laid_out_size = [] {
+        std::size_t offset = 0;
+        std::size_t alignment = 1;
+        const auto place = [&offset, &alignment]<typename MemberT>() {
+            using member = layout_member<MemberT>;
+            if (member::size != 0) {
+                offset = layout_align_up(offset, member::alignment) + member::size;
+            }
+            alignment = std::max(alignment, member::alignment);
+        };
+        (place.template operator()<Ts>(), ...);
+        return std::max<std::size_t>(layout_align_up(offset, alignment), 1);
+    }();
+
+    template <typename F>
+    static constexpr void for_each(F&& f) {
+        (f.template operator()<Ts>(), ...);
+    }
+};
+
+template <typename T>
+struct layout_allocated_of {
+    using type = std::tuple<>;
+};
+
+template <typename T>
+    requires requires { typename T::layout_allocated; }
+struct layout_allocated_of<T> {
+    using type = typename T::layout_allocated;
+};
+
+template <typename T>
+using layout_allocated_t = typename layout_allocated_of<T>::type;
+
+template <typename T>
+struct is_std_tuple : std::false_type {};
+
+template <typename... Ts>
+struct is_std_tuple<std::tuple<Ts...>> : std::true_type {};
+
+// `f` for every owned described member, members of tuples are looked through, references are not expanded
+template <typename MemberT, typename F>
+constexpr void layout_expand(F& f) {
+    if constexpr (!std::is_same_v<MemberT, layout_member_t<MemberT>>) {
+        layout_expand<layout_member_t<MemberT>>(f);
+    } else if constexpr (std::is_reference_v<MemberT>) {
+        return;
+    } else if constexpr (is_std_tuple<std::remove_cv_t<MemberT>>::value) {
+        layout_tuple<std::remove_cv_t<MemberT>>::for_each([&f]<typename ElementT>() { layout_expand<ElementT>(f); });
+    } else if constexpr (LayoutDescribed<std::remove_cv_t<MemberT>>) {
+        f.template operator()<std::remove_cv_t<MemberT>>();
+    }
+}
+
+template <typename T, typename F>
+constexpr void layout_for_each_member(F&& f) {
+    layout_tuple<typename T::layout_members>::for_each([&f]<typename MemberT>() { layout_expand<MemberT>(f); });
+}
+
+} // namespace detail
+
+// `sizeof(T)` as computed from `layout_members`
+template <LayoutDescribed T>
+inline constexpr std::size_t layout_size = detail::layout_tuple<typename T::layout_members>::laid_out_size;
+
+namespace detail {
+
+template <typename T>
+constexpr std::size_t layout_entry_count() noexcept {
+    std::size_t count = 1;
+    if constexpr (LayoutDescribed<T>) {
+        const auto add = [&count]<typename ChildT>() { count += layout_entry_count<ChildT>(); };
+        layout_for_each_member<T>(add);
+        layout_tuple<layout_allocated_t<T>>::for_each(add);
+    }
+    return count;
+}
+
+template <typename T>
+constexpr std::size_t layout_allocation_count() noexcept {
+    std::size_t count = 0;
+    if constexpr (LayoutDescribed<T>) {
+        layout_for_each_member<T>([&count]<typename MemberT>() { count += layout_allocation_count<MemberT>(); });
+        layout_tuple<layout_allocated_t<T>>::for_each([&count]<typename AllocatedT>() {
+            count += 1 + layout_allocation_count<AllocatedT>();
+        });
+    }
+    return count;
+}
+
+template <typename T>
+constexpr void layout_fill(layout_entry*& out, std::size_t depth, bool is_allocated) noexcept {
+    layout_entry& entry = *out++;
+    entry.depth = depth;
+    entry.size = sizeof(T);
+    entry.alignment = alignof(T);
+    entry.is_allocated = is_allocated;
+    if constexpr (LayoutDescribed<T>) {
+        static_assert(layout_size<T> == sizeof(T), "`layout_members` don't add up to the layout of the type");
+        using members_type = layout_tuple<typename T::layout_members>;
+        entry.name = T::layout_name;
+        entry.padding = sizeof(T) - members_type::members_size;
+        layout_for_each_member<T>([&out, depth]<typename MemberT>() { layout_fill<MemberT>(out, depth + 1, false); });
+        layout_tuple<layout_allocated_t<T>>::for_each([&out, depth]<typename AllocatedT>() {
+            layout_fill<AllocatedT>(out, depth + 1, true);
+        });
+    } else {
+        entry.name = "?";
+    }
+}
+
+} // namespace detail
+
+// heap allocations made by the connection itself, not by the executors or the user functors
+template <typename T>
+inline constexpr std::size_t layout_allocation_count_v = detail::layout_allocation_count<T>();
+
+// pre-order, the first entry is `T` itself
+template <typename T>
+constexpr auto layout_of() noexcept {
+    std::array<layout_entry, detail::layout_entry_count<T>()> entries{};
+    layout_entry* out = entries.data();
+    detail::layout_fill<T>(out, 0, false);
+    return entries;
+}
+
+// one line per entry, indented by depth
+void layout_print(std::ostream& os, std::span<const layout_entry> entries);
+
+} // namespace sl::exec
@@ -0,0 +1,88 @@
+//
+// Created by usatiynyan.
+// Multi-shot counterpart of the signal model.
+//
+// A stream delivers any number of `set_next(value)` followed by exactly one terminal call:
+// `set_value(unit)` on exhaustion, `set_error(error)` or `set_null()` on cancellation.
+// Its connection is driven by the consumer:
+//  - `emit()` starts it, no value is delivered before the first `request()`
+//  - `request(n)` allows n more `set_next`-s, exhaustion (`set_value`) and errors take the place of a requested value
+//  - `try_cancel()` ends it with a terminal regardless of the demand (`set_null()` unless another one is under way)
+// `request()` is safe to call from within `set_next()` (the stream defers the delivery until it returns)
+// or from any thread while there's no outstanding request, so it's never concurrent with itself.
+// `try_cancel()` is safe to call from any thread at any point, the one that races the terminal is dropped.
+// The connection is owned by the consumer and can be destroyed once the terminal is delivered (and none of its
+// calls are still running) or while nothing has been requested.
+//
+
+#pragma once
+
+#include "sl/exec/model/executor.hpp"
+#include "sl/exec/model/slot.hpp"
+
+#include <sl/meta/type/unit.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+namespace sl::exec {
+
+template <typename SlotT, typename V, typename E>
+concept StreamSlot = Slot<SlotT, meta::unit, E> && requires(SlotT& slot, V&& value) {
+    { slot.set_next(std::move(value)) } noexcept;
+};
+
+template <typename SlotCtorT, typename V, typename E>
+concept StreamSlotCtor = requires(SlotCtorT slot_ctor) {
+    { std::move(slot_ctor)() } noexcept -> StreamSlot<V, E>;
+};
+
+template <typename StreamConnectionT>
+concept StreamConnection = requires(StreamConnectionT& connection, std::size_t n) {
+    { connection.emit() } noexcept -> std::same_as<void>;
+    { connection.request(n) } noexcept -> std::same_as<void>;
+    { connection.try_cancel() } noexcept -> std::same_as<void>;
+};
+
+template <typename V, typename E>
+struct dummy_stream_slot final {
+    constexpr void set_next(V&&) noexcept {}
+    constexpr void set_value(meta::unit&&) && noexcept {}
+    constexpr void set_error(E&&) && noexcept {}
+    constexpr void set_null() && noexcept {}
+};
+
+template <typename V, typename E>
+struct dummy_stream_slot_ctor final {
+    constexpr StreamSlot<V, E> auto operator()() && noexcept { return dummy_stream_slot<V, E>{}; }
+};
+
+template <typename SomeStreamT>
+concept SomeStream =
+    requires() {
+        typename SomeStreamT::value_type;
+        typename SomeStreamT::error_type;
+    }
+    && requires(
+        SomeStreamT stream,
+        dummy_stream_slot_ctor<typename SomeStreamT::value_type, typename SomeStreamT::error_type> slot_ctor
+    ) {
+           { stream.get_executor() } noexcept -> std::same_as<executor&>;
+           { std::move(stream).subscribe(std::move(slot_ctor)) } noexcept -> StreamConnection;
+       };
+
+template <typename StreamT, typename V, typename E>
+concept Stream = SomeStream<StreamT> //
+                 && std::same_as<V, typename StreamT::value_type> //
+                 && std::same_as<E, typename StreamT::error_type>;
+
+template <SomeStream SomeStreamT, typename SlotCtorT>
+using StreamConnectionFor = decltype(std::declval<SomeStreamT&&>().subscribe(std::declval<SlotCtorT&&>()));
+
+template <SomeStream StreamT, typename ContinuationTV>
+constexpr auto operator|(StreamT&& stream, ContinuationTV&& continuation) {
+    return std::forward<ContinuationTV>(continuation)(std::move(stream));
+}
+
+} // namespace sl::exec
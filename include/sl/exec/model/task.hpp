@@ -6,6 +6,10 @@
 
 #include <sl/meta/intrusive/forward_list.hpp>
 
+#if SL_EXEC_METRICS
+#include <chrono>
+#endif
+
 namespace sl::exec {
 
 struct task {
@@ -16,7 +20,12 @@ struct task {
 
 struct task_node
     : task
-    , meta::intrusive_forward_list_node<task_node> {};
+    , meta::intrusive_forward_list_node<task_node> {
+#if SL_EXEC_METRICS
+    // stamped by instrumented executors on schedule
+    std::chrono::steady_clock::time_point scheduled_at{};
+#endif
+};
 
 using task_list = meta::intrusive_forward_list<task_node>;
 
@@ -1,27 +1,41 @@
 //
 // Created by usatiynyan.
 //
+// arc_release::deferred - decrements are coalesced in a small thread-local batch and applied on overflow,
+// on `arc_flush_deferred`, or on thread exit, trading later destruction for fewer RMWs on the shared refcount.
+//
 
 #pragma once
 
 #include "sl/exec/thread/detail/atomic.hpp"
 #include "sl/exec/thread/detail/polyfill.hpp"
 
+#include <sl/meta/monad/maybe.hpp>
 #include <sl/meta/traits/unique.hpp>
 
 #include <sl/meta/assert.hpp>
 
 #include <array>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 namespace sl::exec {
+
+enum class arc_release {
+    immediate,
+    deferred,
+};
+
 namespace detail {
 
-template <typename T, template <typename> typename Atomic>
-struct [[nodiscard]] arc_storage : meta::immovable {
-    template <typename... Args>
-    explicit arc_storage(std::uint32_t refcount, Args&&... args)
-        : value_{ std::forward<Args>(args)... }, refcount_{ refcount } {}
+template <template <typename> typename Atomic>
+struct [[nodiscard]] arc_control : meta::immovable {
+    using destroy_type = void (*)(arc_control*) noexcept;
+
+    // dispose destroys the value once strong references are gone, deallocate frees the storage after the last weak
+    arc_control(std::uint32_t refcount, destroy_type dispose, destroy_type deallocate)
+        : refcount_{ refcount }, dispose_{ dispose }, deallocate_{ deallocate } {}
 
 public:
     [[nodiscard]] std::uint32_t incref(std::uint32_t diff = 1) & {
@@ -31,32 +45,184 @@ public:
     [[nodiscard]] std::uint32_t decref(std::uint32_t diff = 1) & {
         const std::uint32_t prev = refcount_.fetch_sub(diff, std::memory_order::acq_rel);
         if (prev == diff) {
-            delete this;
+            dispose_(this);
+            weak_decref();
         }
         return prev;
     }
 
+    [[nodiscard]] bool try_incref() & {
+        std::uint32_t refcount = refcount_.load(std::memory_order::relaxed);
+        while (refcount != 0
+               && !refcount_.compare_exchange_weak(
+                   refcount, refcount + 1, std::memory_order::acquire, std::memory_order::relaxed
+               )) {}
+        return refcount != 0;
+    }
+
+    void weak_incref() & { weakcount_.fetch_add(1, std::memory_order::relaxed); }
+
+    void weak_decref() & {
+        // strong references collectively hold a single weak one, so if it's the only one left,
+        // no new weak references can appear and the RMW can be skipped
+        if (weakcount_.load(std::memory_order::acquire) == 1
+            || weakcount_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            deallocate_(this);
+        }
+    }
+
+private:
+    // keeps the refcounts off the value's cache lines
+    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> refcount_;
+    Atomic<std::uint32_t> weakcount_{ 1u };
+    destroy_type dispose_;
+    destroy_type deallocate_;
+};
+
+template <typename T, template <typename> typename Atomic>
+struct [[nodiscard]] arc_storage : arc_control<Atomic> {
+    template <typename... Args>
+    explicit arc_storage(std::uint32_t refcount, Args&&... args)
+        : arc_storage{ refcount, &arc_storage::deallocate, std::forward<Args>(args)... } {}
+
+    // value is destroyed by dispose
+    ~arc_storage() {}
+
+protected:
+    template <typename... Args>
+    arc_storage(std::uint32_t refcount, typename arc_control<Atomic>::destroy_type deallocate, Args&&... args)
+        : arc_control<Atomic>{ refcount, &arc_storage::dispose, deallocate }, value_{ std::forward<Args>(args)... } {}
+
 public:
     T& value() & { return value_; }
     const T& value() const& { return value_; }
 
 private:
-    T value_;
-    alignas(hardware_destructive_interference_size) Atomic<std::uint32_t> refcount_;
+    static void dispose(arc_control<Atomic>* control) noexcept { static_cast<arc_storage*>(control)->value_.~T(); }
+    static void deallocate(arc_control<Atomic>* control) noexcept { delete static_cast<arc_storage*>(control); }
+
+private:
+    union {
+        T value_;
+    };
+};
+
+template <typename T, template <typename> typename Atomic, typename Allocator>
+struct [[nodiscard]] arc_allocated_storage final : arc_storage<T, Atomic> {
+    using allocator_type =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<arc_allocated_storage>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    template <typename... Args>
+    arc_allocated_storage(std::uint32_t refcount, const Allocator& allocator, Args&&... args)
+        : arc_storage<T, Atomic>{ refcount, &arc_allocated_storage::deallocate, std::forward<Args>(args)... },
+          allocator_{ allocator } {}
+
+    template <typename... Args>
+    static arc_allocated_storage* make(std::uint32_t refcount, const Allocator& allocator, Args&&... args) {
+        allocator_type rebound{ allocator };
+        arc_allocated_storage* storage = allocator_traits::allocate(rebound, 1);
+        allocator_traits::construct(rebound, storage, refcount, allocator, std::forward<Args>(args)...);
+        return storage;
+    }
+
+private:
+    static void deallocate(arc_control<Atomic>* control) noexcept {
+        auto* self = static_cast<arc_allocated_storage*>(control);
+        allocator_type rebound{ std::move(self->allocator_) };
+        allocator_traits::destroy(rebound, self);
+        allocator_traits::deallocate(rebound, self, 1);
+    }
+
+private:
+    [[no_unique_address]] allocator_type allocator_;
+};
+
+template <template <typename> typename Atomic>
+struct arc_deferred_batch : meta::immovable {
+    static constexpr std::size_t capacity = 16;
+
+    arc_deferred_batch() = default;
+    ~arc_deferred_batch() { flush(); }
+
+    static arc_deferred_batch& local() {
+        thread_local arc_deferred_batch batch;
+        return batch;
+    }
+
+    void defer(arc_control<Atomic>* control) {
+        for (std::size_t i = 0; i != size_; ++i) {
+            if (entries_[i].control == control) {
+                ++entries_[i].count;
+                return;
+            }
+        }
+        if (size_ == capacity) {
+            flush();
+        }
+        entries_[size_++] = entry{ .control = control, .count = 1u };
+    }
+
+    void flush() {
+        // destructors may defer more decrements, so entries are detached beforehand
+        const std::array<entry, capacity> entries = entries_;
+        const std::size_t size = std::exchange(size_, 0);
+        for (std::size_t i = 0; i != size; ++i) {
+            const std::uint32_t prev = entries[i].control->decref(entries[i].count);
+            ASSERT(prev >= entries[i].count);
+        }
+    }
+
+private:
+    struct entry {
+        arc_control<Atomic>* control;
+        std::uint32_t count;
+    };
+
+    std::array<entry, capacity> entries_{};
+    std::size_t size_ = 0;
 };
 
 } // namespace detail
 
-template <typename T, template <typename> typename Atomic = detail::atomic>
+template <template <typename> typename Atomic = detail::atomic>
+void arc_flush_deferred() {
+    detail::arc_deferred_batch<Atomic>::local().flush();
+}
+
+template <
+    typename T,
+    template <typename> typename Atomic = detail::atomic,
+    arc_release Release = arc_release::immediate>
+struct weak_arc;
+
+template <
+    typename T,
+    template <typename> typename Atomic = detail::atomic,
+    arc_release Release = arc_release::immediate>
 struct [[nodiscard]] arc {
 private:
     explicit arc(detail::arc_storage<T, Atomic>* storage) : storage_{ storage } {}
 
     template <std::uint32_t N, std::uint32_t... Is>
     static auto make_n_impl(detail::arc_storage<T, Atomic>* storage, std::integer_sequence<std::uint32_t, Is...>) {
-        return std::array<arc, N>{ (arc{ storage }, Is)... };
+        return std::array<arc, N>{ ((void)Is, arc{ storage })... };
+    }
+
+    static void release(detail::arc_storage<T, Atomic>* storage) {
+        if (nullptr == storage) {
+            return;
+        }
+        if constexpr (Release == arc_release::deferred) {
+            detail::arc_deferred_batch<Atomic>::local().defer(storage);
+        } else {
+            const std::uint32_t prev = storage->decref();
+            ASSERT(prev > 0u);
+        }
     }
 
+    friend struct weak_arc<T, Atomic, Release>;
+
 public:
     template <typename... Args>
     static arc make(Args&&... args) {
@@ -66,6 +232,16 @@ public:
         } };
     }
 
+    // same as `make`, but storage goes through the allocator, similarly to std::allocate_shared
+    template <typename Allocator, typename... Args>
+    static arc allocate(const Allocator& allocator, Args&&... args) {
+        return arc{ detail::arc_allocated_storage<T, Atomic, Allocator>::make(
+            /* refcount = */ 1u,
+            /* allocator = */ allocator,
+            /* args = */ std::forward<Args>(args)...
+        ) };
+    }
+
     template <std::uint32_t N, typename... Args>
     static std::array<arc, N> make_n(Args&&... args) {
         auto* storage = new detail::arc_storage<T, Atomic>{
@@ -85,15 +261,16 @@ public:
     arc(arc&& other) : storage_{ std::exchange(other.storage_, nullptr) } { ASSERT(storage_); }
 
     arc& operator=(const arc&) = delete;
-    arc& operator=(arc&&) = delete;
-
-    ~arc() noexcept {
-        if (nullptr != storage_) {
-            const std::uint32_t prev = storage_->decref();
-            ASSERT(prev > 0u);
+    arc& operator=(arc&& other) noexcept {
+        ASSERT(other.storage_);
+        if (this != &other) {
+            release(std::exchange(storage_, std::exchange(other.storage_, nullptr)));
         }
+        return *this;
     }
 
+    ~arc() noexcept { release(storage_); }
+
 public:
     T& value() & { return storage_->value(); }
     const T& value() const& { return storage_->value(); }
@@ -108,4 +285,122 @@ private:
     detail::arc_storage<T, Atomic>* storage_;
 };
 
+// does not keep the value alive, only the storage, which allows to break cycles of arc-s
+template <typename T, template <typename> typename Atomic, arc_release Release>
+struct [[nodiscard]] weak_arc {
+    using arc_type = arc<T, Atomic, Release>;
+
+    explicit weak_arc(const arc_type& strong) : storage_{ strong.storage_ } {
+        ASSERT(storage_);
+        storage_->weak_incref();
+    }
+
+    weak_arc(const weak_arc& other) : storage_{ other.storage_ } {
+        ASSERT(storage_);
+        storage_->weak_incref();
+    }
+    weak_arc(weak_arc&& other) : storage_{ std::exchange(other.storage_, nullptr) } { ASSERT(storage_); }
+
+    weak_arc& operator=(const weak_arc&) = delete;
+    weak_arc& operator=(weak_arc&& other) noexcept {
+        ASSERT(other.storage_);
+        if (this != &other) {
+            release(std::exchange(storage_, std::exchange(other.storage_, nullptr)));
+        }
+        return *this;
+    }
+
+    ~weak_arc() noexcept { release(storage_); }
+
+public:
+    [[nodiscard]] meta::maybe<arc_type> upgrade() const& {
+        ASSERT(storage_);
+        if (!storage_->try_incref()) {
+            return meta::null;
+        }
+        return arc_type{ storage_ };
+    }
+
+private:
+    static void release(detail::arc_storage<T, Atomic>* storage) {
+        if (nullptr != storage) {
+            storage->weak_decref();
+        }
+    }
+
+private:
+    detail::arc_storage<T, Atomic>* storage_;
+};
+
+// T embeds the refcount, so there is a single allocation and no extra indirection, but no weak references
+template <typename T, template <typename> typename Atomic = detail::atomic>
+struct intrusive_arc_base : meta::immovable {
+    intrusive_arc_base() = default;
+
+private:
+    template <typename U, template <typename> typename A>
+    friend struct intrusive_arc;
+
+    Atomic<std::uint32_t> refcount_{ 1u };
+};
+
+template <typename T, template <typename> typename Atomic = detail::atomic>
+struct [[nodiscard]] intrusive_arc {
+    static_assert(std::is_base_of_v<intrusive_arc_base<T, Atomic>, T>);
+
+private:
+    explicit intrusive_arc(T* value) : value_{ value } {}
+
+    static void release(T* value) {
+        if (nullptr == value) {
+            return;
+        }
+        intrusive_arc_base<T, Atomic>& base = *value;
+        const std::uint32_t prev = base.refcount_.fetch_sub(1, std::memory_order::acq_rel);
+        ASSERT(prev > 0u);
+        if (prev == 1u) {
+            delete value;
+        }
+    }
+
+public:
+    template <typename... Args>
+    static intrusive_arc make(Args&&... args) {
+        return intrusive_arc{ new T(std::forward<Args>(args)...) };
+    }
+
+public:
+    intrusive_arc(const intrusive_arc& other) : value_{ other.value_ } {
+        ASSERT(value_);
+        intrusive_arc_base<T, Atomic>& base = *value_;
+        const std::uint32_t prev = base.refcount_.fetch_add(1, std::memory_order::relaxed);
+        ASSERT(prev > 0u);
+    }
+    intrusive_arc(intrusive_arc&& other) : value_{ std::exchange(other.value_, nullptr) } { ASSERT(value_); }
+
+    intrusive_arc& operator=(const intrusive_arc&) = delete;
+    intrusive_arc& operator=(intrusive_arc&& other) noexcept {
+        ASSERT(other.value_);
+        if (this != &other) {
+            release(std::exchange(value_, std::exchange(other.value_, nullptr)));
+        }
+        return *this;
+    }
+
+    ~intrusive_arc() noexcept { release(value_); }
+
+public:
+    T& value() & { return *value_; }
+    const T& value() const& { return *value_; }
+
+    T& operator*() & { return value(); }
+    const T& operator*() const& { return value(); }
+
+    T* operator->() & { return value_; }
+    const T* operator->() const& { return value_; }
+
+private:
+    T* value_;
+};
+
 } // namespace sl::exec
@@ -7,10 +7,15 @@
 
 #ifndef SL_EXEC_CONDITION_VARIABLE
 
+#ifdef SL_EXEC_MUTEX_IS_futex
+#include "sl/exec/thread/detail/futex.hpp"
+#define SL_EXEC_CONDITION_VARIABLE ::sl::exec::detail::futex_condition_variable
+#else
 #include <condition_variable>
 #define SL_EXEC_CONDITION_VARIABLE std::condition_variable
+#endif
 
-#endif // SL_EXEC_CONDITION_VARIABLE 
+#endif // SL_EXEC_CONDITION_VARIABLE
 
 namespace sl::exec::detail {
 
@@ -0,0 +1,142 @@
+//
+// Created by usatiynyan.
+//
+// Futex-based primitives for short critical sections, the state words are plain std::atomic,
+// since the kernel has to operate on their addresses directly.
+// On platforms w/o futex they fall back to std::atomic::wait/notify.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace sl::exec::detail {
+
+using futex_word = std::atomic<std::uint32_t>;
+static_assert(sizeof(futex_word) == sizeof(std::uint32_t) && futex_word::is_always_lock_free);
+
+// blocks while word == expected, may wake up spuriously
+void futex_wait(futex_word& word, std::uint32_t expected) noexcept;
+// same as futex_wait, but gives up after timeout
+void futex_wait_for(futex_word& word, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept;
+void futex_wake_one(futex_word& word) noexcept;
+void futex_wake_all(futex_word& word) noexcept;
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Based on "Futexes Are Tricky" by Ulrich Drepper (mutex, take 3), with adaptive spinning before going to sleep.
+class futex_mutex {
+    static constexpr std::uint32_t state_unlocked = 0;
+    static constexpr std::uint32_t state_locked = 1;
+    static constexpr std::uint32_t state_contended = 2;
+
+    static constexpr std::int32_t max_spins = 100;
+
+public:
+    void lock() noexcept {
+        std::uint32_t expected = state_unlocked;
+        if (state_.compare_exchange_strong(
+                expected, state_locked, std::memory_order::acquire, std::memory_order::relaxed
+            )) {
+            return;
+        }
+        lock_slow(expected);
+    }
+
+    bool try_lock() noexcept {
+        std::uint32_t expected = state_unlocked;
+        return state_.compare_exchange_strong(
+            expected, state_locked, std::memory_order::acquire, std::memory_order::relaxed
+        );
+    }
+
+    void unlock() noexcept {
+        if (state_.exchange(state_unlocked, std::memory_order::release) == state_contended) {
+            futex_wake_one(state_);
+        }
+    }
+
+private:
+    void lock_slow(std::uint32_t state) noexcept {
+        // spin estimate is only a hint, so it's racy on purpose, similarly to glibc's PTHREAD_MUTEX_ADAPTIVE_NP
+        const std::int32_t estimate = spin_estimate_.load(std::memory_order::relaxed);
+        const std::int32_t spin_limit = std::min(max_spins, estimate * 2 + 10);
+        std::int32_t spins = 0;
+        for (; spins < spin_limit && state != state_contended; ++spins) {
+            if (state == state_unlocked
+                && state_.compare_exchange_weak(
+                    state, state_locked, std::memory_order::acquire, std::memory_order::relaxed
+                )) {
+                spin_estimate_.store(estimate + (spins - estimate) / 8, std::memory_order::relaxed);
+                return;
+            }
+            cpu_relax();
+            state = state_.load(std::memory_order::relaxed);
+        }
+        spin_estimate_.store(estimate + (spins - estimate) / 8, std::memory_order::relaxed);
+
+        // from now on the lock is acquired in contended state, so that unlock wakes up the next waiter
+        state = state_.exchange(state_contended, std::memory_order::acquire);
+        while (state != state_unlocked) {
+            futex_wait(state_, state_contended);
+            state = state_.exchange(state_contended, std::memory_order::acquire);
+        }
+    }
+
+private:
+    futex_word state_{ state_unlocked };
+    std::atomic<std::int32_t> spin_estimate_{ 0 };
+};
+
+// Sequence-based condition variable, notify skips the syscall if nobody waits.
+// Compatible with any Lock that provides lock/unlock, e.g. std::unique_lock<futex_mutex>.
+class futex_condition_variable {
+public:
+    template <typename Lock>
+    void wait(Lock& lock) noexcept {
+        // seq_cst pairs with notify: either notifier observes the waiter, or the waiter observes new sequence
+        waiters_.fetch_add(1, std::memory_order::seq_cst);
+        const std::uint32_t sequence = sequence_.load(std::memory_order::seq_cst);
+        lock.unlock();
+        futex_wait(sequence_, sequence);
+        waiters_.fetch_sub(1, std::memory_order::relaxed);
+        lock.lock();
+    }
+
+    template <typename Lock, typename Predicate>
+    void wait(Lock& lock, Predicate predicate) {
+        while (!predicate()) {
+            wait(lock);
+        }
+    }
+
+    void notify_one() noexcept {
+        sequence_.fetch_add(1, std::memory_order::seq_cst);
+        if (waiters_.load(std::memory_order::seq_cst) != 0) {
+            futex_wake_one(sequence_);
+        }
+    }
+
+    void notify_all() noexcept {
+        sequence_.fetch_add(1, std::memory_order::seq_cst);
+        if (waiters_.load(std::memory_order::seq_cst) != 0) {
+            futex_wake_all(sequence_);
+        }
+    }
+
+private:
+    futex_word sequence_{ 0u };
+    std::atomic<std::uint32_t> waiters_{ 0u };
+};
+
+} // namespace sl::exec::detail
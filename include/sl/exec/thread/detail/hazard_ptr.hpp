@@ -0,0 +1,223 @@
+//
+// Created by usatiynyan.
+//
+// Based on a paper:
+// Maged M. Michael.
+// "Hazard Pointers: Safe Memory Reclamation for Lock-Free Objects"
+//
+// Every thread owns a record with `slots_per_thread` hazard slots, retired pointers are collected in a thread-local
+// list and reclaimed in batches once none of the published hazards point to them.
+// Leftovers of exiting threads are handed over to whichever thread scans next.
+//
+
+#pragma once
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <sl/meta/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace sl::exec::detail {
+
+template <template <typename> typename Atomic = detail::atomic>
+struct hazard_domain {
+    static constexpr std::size_t max_threads = SL_EXEC_MW_MAX_THREADS_DEFAULT;
+    static constexpr std::size_t slots_per_thread = 2;
+    // amortizes the scan over all published hazards, see "R = H + Omega(H)" in the paper
+    static constexpr std::size_t scan_threshold = 2 * max_threads * slots_per_thread;
+
+    using slot_mask_type = std::uint8_t;
+    static_assert(slots_per_thread <= sizeof(slot_mask_type) * CHAR_BIT);
+
+private:
+    struct retired {
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    struct alignas(hardware_destructive_interference_size) record {
+        Atomic<bool> in_use{ false };
+        std::array<Atomic<void*>, slots_per_thread> slots{};
+    };
+
+    struct orphan {
+        retired value;
+        orphan* next;
+    };
+
+    struct thread_state {
+        thread_state() : record_{ acquire_record() } {}
+
+        ~thread_state() {
+            scan(*this);
+            for (const retired& leftover : retired_) {
+                push_orphan(new orphan{ .value = leftover, .next = nullptr });
+            }
+            release_record(*record_);
+        }
+
+        record* record_;
+        slot_mask_type used_slots_ = 0;
+        std::vector<retired> retired_{};
+    };
+
+public:
+    struct [[nodiscard]] guard final {
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+        guard(guard&& other) noexcept
+            : state_{ std::exchange(other.state_, nullptr) }, slot_index_{ other.slot_index_ } {}
+        guard& operator=(guard&&) = delete;
+
+        ~guard() {
+            if (state_ == nullptr) {
+                return;
+            }
+            reset();
+            state_->used_slots_ &= static_cast<slot_mask_type>(~(slot_mask_type{ 1 } << slot_index_));
+        }
+
+        // publishes the hazard and validates that it is still reachable from src
+        template <typename T>
+        T* protect(const Atomic<T*>& src) {
+            T* ptr = src.load(std::memory_order::relaxed);
+            while (true) {
+                slot().store(ptr, std::memory_order::seq_cst);
+                T* const validated = src.load(std::memory_order::seq_cst);
+                if (validated == ptr) {
+                    return ptr;
+                }
+                ptr = validated;
+            }
+        }
+
+        void reset() { slot().store(nullptr, std::memory_order::release); }
+
+    private:
+        friend struct hazard_domain;
+
+        guard(thread_state& state, std::size_t slot_index) : state_{ &state }, slot_index_{ slot_index } {}
+
+        Atomic<void*>& slot() {
+            DEBUG_ASSERT(state_ != nullptr);
+            return state_->record_->slots[slot_index_];
+        }
+
+    private:
+        thread_state* state_;
+        std::size_t slot_index_;
+    };
+
+public:
+    static guard make_guard() {
+        thread_state& state = local();
+        const auto free_slots = static_cast<slot_mask_type>(~state.used_slots_);
+        const std::size_t slot_index = static_cast<std::size_t>(std::countr_zero(free_slots));
+        ASSERT(slot_index < slots_per_thread, "out of hazard slots");
+        state.used_slots_ |= static_cast<slot_mask_type>(slot_mask_type{ 1 } << slot_index);
+        return guard{ state, slot_index };
+    }
+
+    template <typename T>
+    static void retire(T* ptr) {
+        retire(static_cast<void*>(ptr), [](void* erased) { delete static_cast<T*>(erased); });
+    }
+
+    static void retire(void* ptr, void (*deleter)(void*)) {
+        thread_state& state = local();
+        state.retired_.push_back(retired{ .ptr = ptr, .deleter = deleter });
+        if (state.retired_.size() >= scan_threshold) {
+            scan(state);
+        }
+    }
+
+    // reclaims everything from the current thread's retire list that is not protected at the moment
+    static void reclaim() { scan(local()); }
+
+private:
+    static thread_state& local() {
+        thread_local thread_state state;
+        return state;
+    }
+
+    static record* acquire_record() {
+        for (record& a_record : records_) {
+            bool expected = false;
+            if (!a_record.in_use.load(std::memory_order::relaxed)
+                && a_record.in_use.compare_exchange_strong(
+                    expected, true, std::memory_order::acquire, std::memory_order::relaxed
+                )) {
+                return &a_record;
+            }
+        }
+        PANIC("out of hazard records, consider increasing SL_EXEC_MW_MAX_THREADS_DEFAULT");
+    }
+
+    static void release_record(record& a_record) {
+        for (Atomic<void*>& slot : a_record.slots) {
+            slot.store(nullptr, std::memory_order::relaxed);
+        }
+        a_record.in_use.store(false, std::memory_order::release);
+    }
+
+    static void push_orphan(orphan* new_orphan) {
+        new_orphan->next = orphans_.load(std::memory_order::relaxed);
+        while (!orphans_.compare_exchange_weak(
+            new_orphan->next, new_orphan, std::memory_order::release, std::memory_order::relaxed
+        )) {}
+    }
+
+    static void adopt_orphans(thread_state& state) {
+        if (orphans_.load(std::memory_order::relaxed) == nullptr) {
+            return;
+        }
+        orphan* current = orphans_.exchange(nullptr, std::memory_order::acquire);
+        while (current != nullptr) {
+            state.retired_.push_back(current->value);
+            delete std::exchange(current, current->next);
+        }
+    }
+
+    static void scan(thread_state& state) {
+        adopt_orphans(state);
+        if (state.retired_.empty()) {
+            return;
+        }
+
+        std::vector<void*> hazards;
+        hazards.reserve(max_threads * slots_per_thread);
+        for (record& a_record : records_) {
+            for (Atomic<void*>& slot : a_record.slots) {
+                if (void* hazard = slot.load(std::memory_order::seq_cst); hazard != nullptr) {
+                    hazards.push_back(hazard);
+                }
+            }
+        }
+        std::ranges::sort(hazards);
+
+        // deleters may retire more pointers, so the list is detached beforehand
+        std::vector<retired> candidates = std::exchange(state.retired_, {});
+        for (const retired& candidate : candidates) {
+            if (std::ranges::binary_search(hazards, candidate.ptr)) {
+                state.retired_.push_back(candidate);
+            } else {
+                candidate.deleter(candidate.ptr);
+            }
+        }
+    }
+
+private:
+    static inline std::array<record, max_threads> records_{};
+    alignas(hardware_destructive_interference_size) static inline Atomic<orphan*> orphans_{ nullptr };
+};
+
+} // namespace sl::exec::detail
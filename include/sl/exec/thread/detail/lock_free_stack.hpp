@@ -5,6 +5,7 @@
 #pragma once
 
 #include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/hazard_ptr.hpp"
 
 #include <sl/meta/intrusive/forward_list.hpp>
 
@@ -31,8 +32,32 @@ struct lock_free_stack {
         return old_head;
     }
 
+    // popped (and extracted) nodes can not be reused or deleted directly while other threads are still popping,
+    // they have to go through `retire`, which also rules out ABA on the head
+    static node_type* pop(Atomic<node_type*>& head) {
+        auto guard = hazard_domain<Atomic>::make_guard();
+        node_type* old_head = guard.protect(head);
+
+        while (old_head != nullptr
+               && !head.compare_exchange_weak(
+                   old_head, old_head->intrusive_next, std::memory_order::acquire, std::memory_order::relaxed
+               )) {
+            old_head = guard.protect(head);
+        }
+
+        return old_head;
+    }
+
+    // hazards are published as node_type*, so nodes are retired under the same address
+    static void retire(node_type* node) {
+        hazard_domain<Atomic>::retire(static_cast<void*>(node), [](void* erased) {
+            delete static_cast<T*>(static_cast<node_type*>(erased));
+        });
+    }
+
     void push(node_type* new_node) { push(head_, new_node); }
     node_type* extract() { return extract(head_); }
+    node_type* pop() { return pop(head_); }
 
 private:
     Atomic<node_type*> head_{ nullptr };
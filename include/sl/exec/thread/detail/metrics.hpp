@@ -0,0 +1,179 @@
+//
+// Created by usatiynyan.
+//
+// Executor instrumentation, enabled with SL_EXEC_METRICS.
+// When disabled, the recorder is an empty type w/ no-op hooks, and task_node has no timestamp,
+// so executors pay nothing for it. The snapshot is then always zeroed.
+//
+// Counters are relaxed and are read independently of each other, so the snapshot is not necessarily consistent.
+//
+
+#pragma once
+
+#include "sl/exec/model/task.hpp"
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sl::exec {
+
+// bucket `i` counts samples in [2^(i-1), 2^i) nanoseconds, the last one is open-ended
+struct histogram_snapshot {
+    static constexpr std::size_t bucket_count = 40;
+
+    std::array<std::uint64_t, bucket_count> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t sum_ns = 0;
+
+    // upper bound of the bucket, that contains the given quantile
+    std::chrono::nanoseconds quantile(double q) const {
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i != bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return std::chrono::nanoseconds{ std::int64_t{ 1 } << i };
+            }
+        }
+        return std::chrono::nanoseconds::max();
+    }
+};
+
+struct executor_metrics_snapshot {
+    std::uint64_t queue_depth = 0;
+    std::uint64_t scheduled = 0;
+    std::uint64_t executed = 0;
+    histogram_snapshot schedule_to_execute{};
+    histogram_snapshot execute_duration{};
+    // summed over workers
+    std::chrono::nanoseconds busy{};
+    std::chrono::nanoseconds idle{};
+    std::uint64_t parks = 0;
+};
+
+namespace detail {
+
+using metrics_clock = std::chrono::steady_clock;
+
+#if SL_EXEC_METRICS
+
+template <template <typename> typename Atomic>
+struct histogram {
+    void record(metrics_clock::duration duration) {
+        const auto ns = static_cast<std::uint64_t>(
+            std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0)
+        );
+        const std::size_t index = std::min<std::size_t>(std::bit_width(ns), histogram_snapshot::bucket_count - 1);
+        buckets_[index].fetch_add(1, std::memory_order::relaxed);
+        count_.fetch_add(1, std::memory_order::relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order::relaxed);
+    }
+
+    histogram_snapshot snapshot() const {
+        histogram_snapshot result;
+        for (std::size_t i = 0; i != histogram_snapshot::bucket_count; ++i) {
+            result.buckets[i] = buckets_[i].load(std::memory_order::relaxed);
+        }
+        result.count = count_.load(std::memory_order::relaxed);
+        result.sum_ns = sum_ns_.load(std::memory_order::relaxed);
+        return result;
+    }
+
+private:
+    std::array<Atomic<std::uint64_t>, histogram_snapshot::bucket_count> buckets_{};
+    Atomic<std::uint64_t> count_{ 0 };
+    Atomic<std::uint64_t> sum_ns_{ 0 };
+};
+
+template <template <typename> typename Atomic = detail::atomic>
+struct executor_metrics {
+    using time_point = metrics_clock::time_point;
+
+    void on_schedule(task_node& a_task_node) {
+        a_task_node.scheduled_at = metrics_clock::now();
+        queue_depth_.fetch_add(1, std::memory_order::relaxed);
+        scheduled_.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    // must be called before the task is executed, since it may be destroyed by then
+    time_point on_execute_begin(const task_node& a_task_node) {
+        const time_point now = metrics_clock::now();
+        queue_depth_.fetch_sub(1, std::memory_order::relaxed);
+        schedule_to_execute_.record(now - a_task_node.scheduled_at);
+        return now;
+    }
+
+    void on_execute_end(time_point begin) {
+        const auto duration = metrics_clock::now() - begin;
+        execute_duration_.record(duration);
+        executed_.fetch_add(1, std::memory_order::relaxed);
+        busy_ns_.fetch_add(to_ns(duration), std::memory_order::relaxed);
+    }
+
+    // cancelled tasks leave the queue w/o being executed
+    void on_cancel() { queue_depth_.fetch_sub(1, std::memory_order::relaxed); }
+
+    time_point on_idle_begin() { return metrics_clock::now(); }
+    void on_idle_end(time_point begin) {
+        idle_ns_.fetch_add(to_ns(metrics_clock::now() - begin), std::memory_order::relaxed);
+    }
+    void on_park() { parks_.fetch_add(1, std::memory_order::relaxed); }
+
+    executor_metrics_snapshot snapshot() const {
+        return executor_metrics_snapshot{
+            .queue_depth = queue_depth_.load(std::memory_order::relaxed),
+            .scheduled = scheduled_.load(std::memory_order::relaxed),
+            .executed = executed_.load(std::memory_order::relaxed),
+            .schedule_to_execute = schedule_to_execute_.snapshot(),
+            .execute_duration = execute_duration_.snapshot(),
+            .busy = std::chrono::nanoseconds{ busy_ns_.load(std::memory_order::relaxed) },
+            .idle = std::chrono::nanoseconds{ idle_ns_.load(std::memory_order::relaxed) },
+            .parks = parks_.load(std::memory_order::relaxed),
+        };
+    }
+
+private:
+    static std::uint64_t to_ns(metrics_clock::duration duration) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+
+private:
+    // producers and consumers both touch it
+    alignas(hardware_destructive_interference_size) Atomic<std::uint64_t> queue_depth_{ 0 };
+    alignas(hardware_destructive_interference_size) Atomic<std::uint64_t> scheduled_{ 0 };
+    alignas(hardware_destructive_interference_size) Atomic<std::uint64_t> executed_{ 0 };
+    Atomic<std::uint64_t> busy_ns_{ 0 };
+    Atomic<std::uint64_t> idle_ns_{ 0 };
+    Atomic<std::uint64_t> parks_{ 0 };
+    histogram<Atomic> schedule_to_execute_{};
+    histogram<Atomic> execute_duration_{};
+};
+
+#else
+
+template <template <typename> typename Atomic = detail::atomic>
+struct executor_metrics {
+    using time_point = metrics_clock::time_point;
+
+    constexpr void on_schedule(task_node&) {}
+    constexpr time_point on_execute_begin(const task_node&) { return {}; }
+    constexpr void on_execute_end(time_point) {}
+    constexpr void on_cancel() {}
+    constexpr time_point on_idle_begin() { return {}; }
+    constexpr void on_idle_end(time_point) {}
+    constexpr void on_park() {}
+
+    constexpr executor_metrics_snapshot snapshot() const { return {}; }
+};
+
+#endif
+
+} // namespace detail
+} // namespace sl::exec
@@ -0,0 +1,85 @@
+//
+// Created by usatiynyan.
+//
+// Intrusive MPSC queue by Dmitry Vyukov:
+// https://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+//
+// push is a single exchange, pop is O(1) and FIFO, consumer can start with the first node right away.
+// Links are accessed through std::atomic_ref, since nodes are regular intrusive_forward_list_node-s.
+//
+// NOTE: the queue is not linearizable, while a producer is between exchange and link,
+// the nodes behind it are invisible to the consumer, see `try_pop`.
+//
+
+#pragma once
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <sl/meta/intrusive/forward_list.hpp>
+#include <sl/meta/traits/unique.hpp>
+
+#include <atomic>
+
+namespace sl::exec::detail {
+
+template <typename T, template <typename> typename Atomic = detail::atomic>
+struct mpsc_queue : meta::immovable {
+    using node_type = meta::intrusive_forward_list_node<T>;
+
+    mpsc_queue() : head_{ &stub_ }, tail_{ &stub_ } {}
+
+    // any thread
+    void push(node_type* node) {
+        next(node).store(nullptr, std::memory_order::relaxed);
+        node_type* prev = head_.exchange(node, std::memory_order::acq_rel);
+        next(prev).store(node, std::memory_order::release);
+    }
+
+    // consumer only
+    // returns nullptr if the queue is empty, or if a producer has not linked its node yet
+    node_type* try_pop() {
+        node_type* tail = tail_;
+        node_type* next_node = next(tail).load(std::memory_order::acquire);
+
+        if (tail == &stub_) {
+            if (next_node == nullptr) {
+                return nullptr;
+            }
+            tail_ = next_node;
+            tail = next_node;
+            next_node = next(next_node).load(std::memory_order::acquire);
+        }
+
+        if (next_node != nullptr) {
+            tail_ = next_node;
+            return tail;
+        }
+
+        if (tail != head_.load(std::memory_order::acquire)) {
+            return nullptr;
+        }
+
+        // tail is the last node, stub takes its place so that tail can be handed out
+        push(&stub_);
+
+        next_node = next(tail).load(std::memory_order::acquire);
+        if (next_node != nullptr) {
+            tail_ = next_node;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    static std::atomic_ref<node_type*> next(node_type* node) {
+        return std::atomic_ref<node_type*>{ node->intrusive_next };
+    }
+
+private:
+    alignas(hardware_destructive_interference_size) Atomic<node_type*> head_;
+    alignas(hardware_destructive_interference_size) node_type* tail_;
+    node_type stub_{};
+};
+
+} // namespace sl::exec::detail
@@ -8,7 +8,13 @@
 #ifndef SL_EXEC_MUTEX
 
 #include <mutex>
+
+#ifdef SL_EXEC_MUTEX_IS_futex
+#include "sl/exec/thread/detail/futex.hpp"
+#define SL_EXEC_MUTEX ::sl::exec::detail::futex_mutex
+#else
 #define SL_EXEC_MUTEX std::mutex
+#endif
 
 #endif // SL_EXEC_MUTEX
 
@@ -0,0 +1,107 @@
+//
+// Created by usatiynyan.
+//
+// Task tracing, enabled with SL_EXEC_TRACE.
+// Every thread writes into its own ring buffer (single writer, the oldest events are overwritten),
+// buffers outlive their threads, so the trace can be exported at any point via `trace_export_chrome`.
+// When disabled, the hooks are empty and the exporter writes an empty trace.
+//
+// Exporting and clearing while threads are still running is fine: the export copies every ring and then drops
+// the events that the owning thread might've overwritten during the copy, clearing doesn't touch the rings at all.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace sl::exec {
+
+// Chrome trace-event JSON, can be opened with chrome://tracing or https://ui.perfetto.dev
+void trace_export_chrome(std::ostream& os);
+
+// drops all the recorded events
+void trace_clear();
+
+namespace detail {
+
+#if SL_EXEC_TRACE
+
+struct trace_event {
+    enum class phase : char {
+        complete = 'X',
+        instant = 'i',
+    };
+
+    const char* category;
+    const char* name;
+    const void* executor;
+    std::uint64_t ts_ns;
+    std::uint64_t duration_ns;
+    phase ph;
+};
+
+inline constexpr std::size_t trace_buffer_capacity = 1u << 12;
+
+std::uint64_t trace_now_ns() noexcept;
+void trace_record(const trace_event& event) noexcept;
+
+inline void trace_schedule(const char* category, const void* executor) noexcept {
+    trace_record(trace_event{
+        .category = category,
+        .name = "schedule",
+        .executor = executor,
+        .ts_ns = trace_now_ns(),
+        .duration_ns = 0,
+        .ph = trace_event::phase::instant,
+    });
+}
+
+inline void trace_slot(const char* category, const char* name) noexcept {
+    trace_record(trace_event{
+        .category = category,
+        .name = name,
+        .executor = nullptr,
+        .ts_ns = trace_now_ns(),
+        .duration_ns = 0,
+        .ph = trace_event::phase::instant,
+    });
+}
+
+struct [[nodiscard]] trace_execute_scope {
+    trace_execute_scope(const char* category, const void* executor) noexcept
+        : category_{ category }, executor_{ executor }, begin_ns_{ trace_now_ns() } {}
+    ~trace_execute_scope() noexcept {
+        trace_record(trace_event{
+            .category = category_,
+            .name = "execute",
+            .executor = executor_,
+            .ts_ns = begin_ns_,
+            .duration_ns = trace_now_ns() - begin_ns_,
+            .ph = trace_event::phase::complete,
+        });
+    }
+
+    trace_execute_scope(const trace_execute_scope&) = delete;
+    trace_execute_scope& operator=(const trace_execute_scope&) = delete;
+
+private:
+    const char* category_;
+    const void* executor_;
+    std::uint64_t begin_ns_;
+};
+
+#else
+
+constexpr void trace_schedule(const char*, const void*) noexcept {}
+constexpr void trace_slot(const char*, const char*) noexcept {}
+
+struct [[nodiscard]] trace_execute_scope {
+    constexpr trace_execute_scope(const char*, const void*) noexcept {}
+};
+
+#endif
+
+} // namespace detail
+} // namespace sl::exec
@@ -29,9 +29,12 @@ public:
         return true;
     }
 
-    meta::intrusive_forward_list_node<T>* try_pop() {
+    // on_park is invoked every time the caller is about to block
+    template <typename OnParkF = void (*)()>
+    meta::intrusive_forward_list_node<T>* try_pop(OnParkF&& on_park = [] {}) {
         std::unique_lock lock{ m_ };
         while (q_.empty() && !is_closed_) {
+            on_park();
             event_.wait(lock);
         }
         auto* node = q_.pop_front();
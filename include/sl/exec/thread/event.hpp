@@ -5,6 +5,7 @@
 #pragma once
 
 #include "sl/exec/thread/event/atomic.hpp"
+#include "sl/exec/thread/event/futex.hpp"
 #include "sl/exec/thread/event/mutex.hpp"
 #include "sl/exec/thread/event/nowait.hpp"
 
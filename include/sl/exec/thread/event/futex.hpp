@@ -0,0 +1,40 @@
+//
+// Created by usatiynyan.
+//
+
+#pragma once
+
+#include "sl/exec/thread/detail/futex.hpp"
+
+namespace sl::exec {
+
+// one-shot, set() only goes to the kernel if someone is already sleeping in wait()
+struct futex_event {
+    void set() {
+        if (state_.exchange(state_set, std::memory_order::release) == state_waiting) {
+            detail::futex_wake_all(state_);
+        }
+    }
+
+    void wait() {
+        std::uint32_t state = state_unset;
+        if (state_.compare_exchange_strong(
+                state, state_waiting, std::memory_order::acquire, std::memory_order::acquire
+            )) {
+            state = state_waiting;
+        }
+        while (state != state_set) {
+            detail::futex_wait(state_, state_waiting);
+            state = state_.load(std::memory_order::acquire);
+        }
+    }
+
+private:
+    static constexpr std::uint32_t state_unset = 0;
+    static constexpr std::uint32_t state_set = 1;
+    static constexpr std::uint32_t state_waiting = 2;
+
+    detail::futex_word state_{ state_unset };
+};
+
+} // namespace sl::exec
@@ -14,6 +14,7 @@ struct mutex_event {
     void set() {
         std::lock_guard lock{ m_ };
         is_set_ = true;
+        cv_.notify_one();
     }
     void wait() {
         std::unique_lock lock{ m_ };
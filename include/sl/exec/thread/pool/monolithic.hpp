@@ -7,9 +7,11 @@
 #include "sl/exec/model/executor.hpp"
 
 #include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/metrics.hpp"
+#include "sl/exec/thread/detail/trace.hpp"
 #include "sl/exec/thread/detail/unbound_blocking_queue.hpp"
 #include "sl/exec/thread/pool/config.hpp"
-#include "sl/exec/thread/sync/wait_group.hpp"
+#include "sl/exec/thread/sync/sharded_wait_group.hpp"
 
 #include <sl/meta/assert.hpp>
 #include <sl/meta/traits/unique.hpp>
@@ -24,11 +26,12 @@ struct monolithic_thread_pool final
     , meta::immovable {
 
     // starts when initialized
-    explicit monolithic_thread_pool(thread_pool_config config) {
+    // idle tracking has a shard per worker and one for the outside threads
+    explicit monolithic_thread_pool(thread_pool_config config) : wg_{ config.tcount + 1u } {
         ASSERT(config.tcount > 0);
         workers_.reserve(config.tcount);
         for (std::uint32_t i = 0; i < config.tcount; ++i) {
-            workers_.emplace_back([this] { worker_job(); });
+            workers_.emplace_back([this, i] { worker_job(i); });
         }
     }
     ~monolithic_thread_pool() noexcept override {
@@ -38,7 +41,9 @@ struct monolithic_thread_pool final
     }
 
     void schedule(task_node& a_task_node) noexcept override {
-        wg_.add(1u);
+        detail::trace_schedule("monolithic", this);
+        wg_.add(current_shard(), 1u);
+        metrics_.on_schedule(a_task_node);
         tq_.push(&a_task_node);
     }
 
@@ -52,22 +57,53 @@ struct monolithic_thread_pool final
         workers_.clear();
     }
 
+    // one shard per worker and one for the outside threads, unlike `workers_` it's not touched by `stop`
+    std::size_t concurrency_hint() const noexcept override { return wg_.shard_count() - 1; }
 
     void wait_idle() { wg_.wait(); }
 
+    // zeroed unless built w/ SL_EXEC_METRICS
+    executor_metrics_snapshot metrics() const { return metrics_.snapshot(); }
+
 private:
-    void worker_job() {
-        while (auto* maybe_task = tq_.try_pop()) {
+    void worker_job(std::uint32_t index) {
+        current_worker = worker_context{ .pool = this, .index = index };
+        while (true) {
+            const auto idle_begin = metrics_.on_idle_begin();
+            auto* maybe_task = tq_.try_pop([this] { metrics_.on_park(); });
+            metrics_.on_idle_end(idle_begin);
+            if (maybe_task == nullptr) {
+                break;
+            }
+
             auto* task = maybe_task->downcast();
-            task->execute();
-            wg_.done();
+            const auto execute_begin = metrics_.on_execute_begin(*task);
+            {
+                detail::trace_execute_scope trace_scope{ "monolithic", this };
+                task->execute();
+            }
+            metrics_.on_execute_end(execute_begin);
+            wg_.done(index);
         }
+        current_worker = worker_context{};
     }
 
+    std::size_t current_shard() const {
+        return current_worker.pool == this ? current_worker.index : wg_.shard_count() - 1;
+    }
+
+private:
+    struct worker_context {
+        const monolithic_thread_pool* pool = nullptr;
+        std::uint32_t index = 0;
+    };
+    static inline thread_local worker_context current_worker{};
+
 private:
     std::vector<std::thread> workers_;
     detail::unbound_blocking_queue<task_node> tq_;
-    wait_group<Atomic> wg_;
+    sharded_wait_group<Atomic> wg_;
+    [[no_unique_address]] detail::executor_metrics<Atomic> metrics_;
 };
 
 } // namespace sl::exec
@@ -4,4 +4,5 @@
 
 #pragma once
 
+#include "sl/exec/thread/sync/sharded_wait_group.hpp"
 #include "sl/exec/thread/sync/wait_group.hpp"
@@ -0,0 +1,81 @@
+//
+// Created by usatiynyan.
+//
+// Same as wait_group, but add/done go to per-shard monotonic counters, so that producers and consumers
+// with distinct shards do not contend on a single cache line.
+// wait() aggregates the shards: done-s are read before add-s, since every add happens-before its done,
+// equal sums mean that nothing counted is still in flight.
+//
+
+#pragma once
+
+#include "sl/exec/thread/detail/atomic.hpp"
+#include "sl/exec/thread/detail/polyfill.hpp"
+
+#include <sl/meta/assert.hpp>
+#include <sl/meta/traits/unique.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sl::exec {
+
+template <template <typename> typename Atomic>
+struct sharded_wait_group : meta::immovable {
+    explicit sharded_wait_group(std::size_t shard_count) : shards_(shard_count) { ASSERT(shard_count > 0); }
+
+    std::size_t shard_count() const { return shards_.size(); }
+
+    void add(std::size_t shard, std::uint32_t count) {
+        DEBUG_ASSERT(shard < shards_.size());
+        shards_[shard].added.fetch_add(count, std::memory_order::relaxed);
+    }
+
+    void done(std::size_t shard) {
+        DEBUG_ASSERT(shard < shards_.size());
+        // seq_cst pairs with wait: either the waiter is observed here, or it observes this done
+        shards_[shard].done.fetch_add(1, std::memory_order::seq_cst);
+        if (waiters_.load(std::memory_order::seq_cst) != 0) {
+            epoch_.fetch_add(1, std::memory_order::release);
+            epoch_.notify_all();
+        }
+    }
+
+    void wait() {
+        waiters_.fetch_add(1, std::memory_order::seq_cst);
+        while (true) {
+            const std::uint32_t epoch = epoch_.load(std::memory_order::acquire);
+            if (is_idle()) {
+                break;
+            }
+            epoch_.wait(epoch, std::memory_order::relaxed);
+        }
+        waiters_.fetch_sub(1, std::memory_order::relaxed);
+    }
+
+private:
+    bool is_idle() const {
+        std::uint64_t done = 0;
+        for (const shard& a_shard : shards_) {
+            done += a_shard.done.load(std::memory_order::seq_cst);
+        }
+        std::uint64_t added = 0;
+        for (const shard& a_shard : shards_) {
+            added += a_shard.added.load(std::memory_order::acquire);
+        }
+        DEBUG_ASSERT(added >= done);
+        return added == done;
+    }
+
+private:
+    struct alignas(detail::hardware_destructive_interference_size) shard {
+        Atomic<std::uint64_t> added{ 0 };
+        Atomic<std::uint64_t> done{ 0 };
+    };
+
+    std::vector<shard> shards_;
+    alignas(detail::hardware_destructive_interference_size) Atomic<std::uint32_t> waiters_{ 0 };
+    Atomic<std::uint32_t> epoch_{ 0 };
+};
+
+} // namespace sl::exec
@@ -14,10 +14,15 @@ manual_executor::~manual_executor() noexcept {
     }
 }
 
-void manual_executor::schedule(task_node& a_task_node) noexcept { task_queue_.push_back(&a_task_node); }
+void manual_executor::schedule(task_node& a_task_node) noexcept {
+    detail::trace_schedule("manual", this);
+    metrics_.on_schedule(a_task_node);
+    task_queue_.push_back(&a_task_node);
+}
 
 void manual_executor::stop() noexcept {
     for (auto& task_node : task_queue_) {
+        metrics_.on_cancel();
         task_node.cancel();
     }
     task_queue_.clear();
@@ -26,7 +31,7 @@ void manual_executor::stop() noexcept {
 std::size_t manual_executor::execute_batch() noexcept {
     task_list batch = std::move(task_queue_); // clears task_queue_
     for (auto& task_node : batch) {
-        task_node.execute();
+        execute(task_node);
     }
     return batch.size();
 }
@@ -38,9 +43,16 @@ std::size_t manual_executor::execute_at_most(std::size_t n) noexcept {
         if (task_node == nullptr) {
             break;
         }
-        task_node->execute();
+        execute(*task_node);
     }
     return counter;
 }
 
+void manual_executor::execute(task_node& a_task_node) noexcept {
+    const auto execute_begin = metrics_.on_execute_begin(a_task_node);
+    detail::trace_execute_scope trace_scope{ "manual", this };
+    a_task_node.execute();
+    metrics_.on_execute_end(execute_begin);
+}
+
 } // namespace sl::exec
@@ -0,0 +1,150 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo/sched/run_loop.hpp"
+
+#include <sl/meta/assert.hpp>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <thread>
+#include <tuple>
+
+namespace sl::exec {
+
+run_loop_executor::run_loop_executor(run_loop_config config) {
+#if defined(__linux__)
+    if (config.with_eventfd) {
+        event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        ASSERT(event_fd_ != -1, "failed to create eventfd");
+    }
+#else
+    std::ignore = config;
+#endif
+}
+
+run_loop_executor::~run_loop_executor() noexcept {
+    if (!ASSERT_VAL(pending_.load(std::memory_order::acquire) == 0, "executor destroyed with unfinished tasks")) {
+        stop();
+    }
+#if defined(__linux__)
+    if (event_fd_ != -1) {
+        ::close(event_fd_);
+    }
+#endif
+}
+
+void run_loop_executor::schedule(task_node& a_task_node) noexcept {
+    detail::trace_schedule("run_loop", this);
+    queue_.push(&a_task_node);
+    // seq_cst pairs with the owner going to sleep, see `wait`
+    if (pending_.fetch_add(1, std::memory_order::seq_cst) == 0) {
+        notify();
+    }
+}
+
+void run_loop_executor::stop() noexcept {
+    const std::uint32_t batch_size = pending_.load(std::memory_order::acquire);
+    for (std::uint32_t popped = 0; popped != batch_size; ++popped) {
+        pop_counted(popped)->cancel();
+    }
+    pending_.fetch_sub(batch_size, std::memory_order::relaxed);
+}
+
+std::size_t run_loop_executor::run_once() noexcept {
+    clear_eventfd();
+
+    // tasks scheduled by the batch itself are left for the next run
+    const std::uint32_t batch_size = pending_.load(std::memory_order::acquire);
+    for (std::uint32_t popped = 0; popped != batch_size; ++popped) {
+        task_node* a_task_node = pop_counted(popped);
+        detail::trace_execute_scope trace_scope{ "run_loop", this };
+        a_task_node->execute();
+    }
+
+    const std::uint32_t pending_before = pending_.fetch_sub(batch_size, std::memory_order::relaxed);
+    if (pending_before > batch_size) {
+        // nobody is going to notify, since the counter has not dropped to 0
+        signal_eventfd();
+    }
+    return batch_size;
+}
+
+std::size_t run_loop_executor::run_for(std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::size_t counter = 0;
+    while (true) {
+        const std::uint32_t epoch = epoch_.load(std::memory_order::acquire);
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return counter;
+        }
+        const std::size_t batch_size = run_once();
+        if (batch_size == 0) {
+            wait_for(epoch, deadline - now);
+        }
+        counter += batch_size;
+    }
+}
+
+void run_loop_executor::wake() noexcept { notify(); }
+
+task_node* run_loop_executor::pop_counted(std::uint32_t popped) noexcept {
+    while (true) {
+        if (auto* node = queue_.try_pop()) {
+            return node->downcast();
+        }
+        // the task is accounted in pending_, so its producer is in the middle of a push
+        DEBUG_ASSERT(pending_.load(std::memory_order::relaxed) > popped);
+        std::this_thread::yield();
+    }
+}
+
+void run_loop_executor::notify() noexcept {
+    epoch_.fetch_add(1, std::memory_order::seq_cst);
+    signal_eventfd();
+    if (is_sleeping_.load(std::memory_order::seq_cst)) {
+        detail::futex_wake_one(epoch_);
+    }
+}
+
+void run_loop_executor::wait(std::uint32_t epoch) noexcept {
+    is_sleeping_.store(true, std::memory_order::seq_cst);
+    if (pending_.load(std::memory_order::seq_cst) == 0) {
+        detail::futex_wait(epoch_, epoch);
+    }
+    is_sleeping_.store(false, std::memory_order::relaxed);
+}
+
+void run_loop_executor::wait_for(std::uint32_t epoch, std::chrono::nanoseconds timeout) noexcept {
+    is_sleeping_.store(true, std::memory_order::seq_cst);
+    if (pending_.load(std::memory_order::seq_cst) == 0) {
+        detail::futex_wait_for(epoch_, epoch, timeout);
+    }
+    is_sleeping_.store(false, std::memory_order::relaxed);
+}
+
+void run_loop_executor::signal_eventfd() noexcept {
+#if defined(__linux__)
+    if (event_fd_ != -1) {
+        // EAGAIN means the counter is saturated, which is still readable
+        std::ignore = ::eventfd_write(event_fd_, 1);
+    }
+#endif
+}
+
+void run_loop_executor::clear_eventfd() noexcept {
+#if defined(__linux__)
+    if (event_fd_ != -1) {
+        eventfd_t value = 0;
+        // EAGAIN means it was not signalled
+        std::ignore = ::eventfd_read(event_fd_, &value);
+    }
+#endif
+}
+
+} // namespace sl::exec
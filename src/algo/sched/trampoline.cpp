@@ -0,0 +1,58 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/algo/sched/trampoline.hpp"
+
+namespace sl::exec {
+namespace {
+
+struct trampoline_state {
+    std::size_t depth = 0;
+    task_list deferred{};
+};
+
+trampoline_state& local_state() {
+    thread_local trampoline_state state;
+    return state;
+}
+
+} // namespace
+
+void trampoline_executor::schedule(task_node& a_task_node) noexcept {
+    trampoline_state& state = local_state();
+    if (state.depth >= max_depth_) {
+        state.deferred.push_back(&a_task_node);
+        return;
+    }
+
+    ++state.depth;
+    {
+        detail::trace_execute_scope trace_scope{ "trampoline", this };
+        a_task_node.execute();
+    }
+    if (state.depth == 1) {
+        // outermost frame, every deferred task starts over from the shallowest depth
+        while (task_node* deferred = state.deferred.pop_front()) {
+            detail::trace_execute_scope trace_scope{ "trampoline", this };
+            deferred->execute();
+        }
+    }
+    --state.depth;
+}
+
+void trampoline_executor::stop() noexcept {
+    trampoline_state& state = local_state();
+    while (task_node* deferred = state.deferred.pop_front()) {
+        deferred->cancel();
+    }
+}
+
+std::size_t trampoline_executor::current_depth() noexcept { return local_state().depth; }
+
+executor& trampoline_inline_executor() {
+    static trampoline_executor an_executor;
+    return an_executor;
+}
+
+} // namespace sl::exec
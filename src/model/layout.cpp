@@ -0,0 +1,21 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/model/layout.hpp"
+
+#include <ostream>
+
+namespace sl::exec {
+
+void layout_print(std::ostream& os, std::span<const layout_entry> entries) {
+    for (const layout_entry& entry : entries) {
+        for (std::size_t i = 0; i != entry.depth; ++i) {
+            os << "  ";
+        }
+        os << (entry.is_allocated ? "*" : "") << entry.name << " size=" << entry.size << " align=" << entry.alignment
+           << " padding=" << entry.padding << '\n';
+    }
+}
+
+} // namespace sl::exec
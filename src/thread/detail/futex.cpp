@@ -0,0 +1,68 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/thread/detail/futex.hpp"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+#include <ctime>
+#endif
+
+#include <thread>
+#include <tuple>
+
+namespace sl::exec::detail {
+
+#if defined(__linux__)
+
+namespace {
+
+long futex(futex_word& word, int op, std::uint32_t value, const timespec* timeout = nullptr) noexcept {
+    return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+
+} // namespace
+
+void futex_wait(futex_word& word, std::uint32_t expected) noexcept {
+    // EAGAIN (value changed) and EINTR are both fine, callers re-check the state anyway
+    std::ignore = futex(word, FUTEX_WAIT_PRIVATE, expected);
+}
+
+void futex_wait_for(futex_word& word, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    const timespec relative_timeout{
+        .tv_sec = static_cast<time_t>(seconds.count()),
+        .tv_nsec = static_cast<long>((timeout - seconds).count()),
+    };
+    // ETIMEDOUT is reported the same way as a wake up
+    std::ignore = futex(word, FUTEX_WAIT_PRIVATE, expected, &relative_timeout);
+}
+
+void futex_wake_one(futex_word& word) noexcept { std::ignore = futex(word, FUTEX_WAKE_PRIVATE, 1); }
+
+void futex_wake_all(futex_word& word) noexcept { std::ignore = futex(word, FUTEX_WAKE_PRIVATE, INT_MAX); }
+
+#else
+
+void futex_wait(futex_word& word, std::uint32_t expected) noexcept { word.wait(expected, std::memory_order::relaxed); }
+
+// std::atomic::wait has no timeout, so poll instead
+void futex_wait_for(futex_word& word, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (word.load(std::memory_order::relaxed) == expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void futex_wake_one(futex_word& word) noexcept { word.notify_one(); }
+
+void futex_wake_all(futex_word& word) noexcept { word.notify_all(); }
+
+#endif
+
+} // namespace sl::exec::detail
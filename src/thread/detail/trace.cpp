@@ -0,0 +1,164 @@
+//
+// Created by usatiynyan.
+//
+
+#include "sl/exec/thread/detail/trace.hpp"
+
+#if SL_EXEC_TRACE
+#include "sl/exec/thread/detail/mutex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#endif
+
+#include <ostream>
+
+namespace sl::exec {
+
+#if SL_EXEC_TRACE
+
+namespace {
+
+struct trace_buffer {
+    explicit trace_buffer(std::uint32_t tid) : tid{ tid } {}
+
+    const std::uint32_t tid;
+    // written by the owning thread only: `begun` is bumped before an event is written and `written` after it,
+    // so the exporter can tell which of the events it has copied might've been overwritten in the meantime
+    std::atomic<std::uint64_t> begun{ 0 };
+    std::atomic<std::uint64_t> written{ 0 };
+    // events before it are dropped, written by `trace_clear` under the registry mutex
+    std::atomic<std::uint64_t> cleared{ 0 };
+    std::array<detail::trace_event, detail::trace_buffer_capacity> events{};
+};
+
+struct trace_registry {
+    trace_buffer& register_thread() {
+        std::lock_guard lock{ m };
+        const auto tid = static_cast<std::uint32_t>(buffers.size());
+        return *buffers.emplace_back(std::make_unique<trace_buffer>(tid));
+    }
+
+    detail::mutex m;
+    std::vector<std::unique_ptr<trace_buffer>> buffers;
+};
+
+trace_registry& registry() {
+    // leaked on purpose, so that threads exiting after main could still write into their buffers
+    static trace_registry* instance = new trace_registry{};
+    return *instance;
+}
+
+trace_buffer& local_buffer() {
+    thread_local trace_buffer& buffer = registry().register_thread();
+    return buffer;
+}
+
+void write_escaped(std::ostream& os, const char* str) {
+    for (; *str != '\0'; ++str) {
+        if (*str == '"' || *str == '\\') {
+            os << '\\';
+        }
+        os << *str;
+    }
+}
+
+// microseconds w/ all 3 digits of the fraction, regardless of the magnitude and the stream state
+void write_us(std::ostream& os, std::uint64_t ns) {
+    const std::uint64_t fraction = ns % 1000;
+    os << ns / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+
+} // namespace
+
+namespace detail {
+
+std::uint64_t trace_now_ns() noexcept {
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()
+    );
+}
+
+void trace_record(const trace_event& event) noexcept {
+    trace_buffer& buffer = local_buffer();
+    const std::uint64_t index = buffer.written.load(std::memory_order::relaxed);
+    buffer.begun.store(index + 1, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::release);
+    buffer.events[index % trace_buffer_capacity] = event;
+    buffer.written.store(index + 1, std::memory_order::release);
+}
+
+} // namespace detail
+
+void trace_export_chrome(std::ostream& os) {
+    trace_registry& a_registry = registry();
+    std::lock_guard lock{ a_registry.m };
+
+    os << "{\"traceEvents\":[";
+    bool is_first = true;
+    std::vector<detail::trace_event> snapshot;
+    snapshot.reserve(detail::trace_buffer_capacity);
+    for (const auto& buffer : a_registry.buffers) {
+        // seqlock-like snapshot, the owning thread keeps on writing meanwhile
+        const std::uint64_t written = buffer->written.load(std::memory_order::acquire);
+        const std::uint64_t begin = std::max(
+            written - std::min<std::uint64_t>(written, detail::trace_buffer_capacity),
+            buffer->cleared.load(std::memory_order::relaxed)
+        );
+        snapshot.clear();
+        for (std::uint64_t i = begin; i < written; ++i) {
+            snapshot.push_back(buffer->events[i % detail::trace_buffer_capacity]);
+        }
+        std::atomic_thread_fence(std::memory_order::acquire);
+        const std::uint64_t begun = buffer->begun.load(std::memory_order::relaxed);
+        // everything before it might've been overwritten while copying
+        const std::uint64_t intact = begun - std::min<std::uint64_t>(begun, detail::trace_buffer_capacity);
+
+        for (std::uint64_t i = std::max(begin, intact); i < written; ++i) {
+            const detail::trace_event& event = snapshot[i - begin];
+            os << (std::exchange(is_first, false) ? "" : ",") << "{\"name\":\"";
+            write_escaped(os, event.name);
+            os << "\",\"cat\":\"";
+            write_escaped(os, event.category);
+            os << "\",\"ph\":\"" << static_cast<char>(event.ph) << "\",\"pid\":0,\"tid\":" << buffer->tid << ",\"ts\":";
+            write_us(os, event.ts_ns);
+            if (event.ph == detail::trace_event::phase::complete) {
+                os << ",\"dur\":";
+                write_us(os, event.duration_ns);
+            } else {
+                os << ",\"s\":\"t\"";
+            }
+            if (event.executor != nullptr) {
+                os << ",\"args\":{\"executor\":\"" << event.executor << "\"}";
+            }
+            os << '}';
+        }
+    }
+    os << "]}";
+}
+
+void trace_clear() {
+    trace_registry& a_registry = registry();
+    std::lock_guard lock{ a_registry.m };
+    for (const auto& buffer : a_registry.buffers) {
+        // the owning thread's counters are left alone, the export just skips what was there before
+        buffer->cleared.store(buffer->written.load(std::memory_order::acquire), std::memory_order::relaxed);
+    }
+}
+
+#else
+
+void trace_export_chrome(std::ostream& os) { os << "{\"traceEvents\":[]}"; }
+
+void trace_clear() {}
+
+#endif
+
+} // namespace sl::exec
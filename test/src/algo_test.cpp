@@ -11,6 +11,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+
 namespace sl::exec {
 
 TEST(conn, valueSignal) {
@@ -56,6 +61,29 @@ TEST(algo, orElse) {
     ASSERT_EQ(*maybe_result, meta::err(std::string{ "43" }));
 }
 
+TEST(algo, seqFusion) {
+    manual_executor executor;
+
+    std::string result;
+    as_signal(meta::result<int, int>(42)) //
+        | continue_on(executor)
+        | map([](int i) { return i + 1; })
+        | and_then([](int i) { return meta::result<int, int>(meta::err(i + 1)); })
+        | map([](int i) { return i * 2; }) // skipped
+        | or_else([](int i) { return meta::result<int, std::string>(i + 1); })
+        | map([&result](int i) {
+              result = std::to_string(i);
+              return meta::unit{};
+          })
+        | detach();
+
+    EXPECT_TRUE(result.empty());
+    // all of the stages are run by a single task
+    EXPECT_EQ(executor.execute_at_most(1), 1);
+    EXPECT_EQ(result, "45");
+    EXPECT_EQ(executor.execute_batch(), 0);
+}
+
 TEST(algo, manualStartOn) {
     manual_executor executor;
 
@@ -177,6 +205,280 @@ TEST(algo, share) {
     EXPECT_EQ(maybe_result4->value(), 42);
 }
 
+TEST(algo, whenAllRange) {
+    manual_executor executor;
+    constexpr std::size_t shard_count = 100;
+
+    const auto query = [&executor](std::size_t shard) {
+        return schedule(executor, [shard] { return meta::ok(shard); });
+    };
+    std::vector<decltype(query(0))> signals;
+    for (std::size_t i = 0; i != shard_count; ++i) {
+        signals.push_back(query(i));
+    }
+
+    meta::maybe<std::vector<std::size_t>> maybe_result;
+    when_all(std::move(signals)) //
+        | map([&maybe_result](std::vector<std::size_t> result) {
+              maybe_result.emplace(std::move(result));
+              return meta::unit{};
+          })
+        | detach();
+    EXPECT_FALSE(maybe_result.has_value());
+
+    EXPECT_EQ(executor.execute_batch(), shard_count);
+    ASSERT_TRUE(maybe_result.has_value());
+    ASSERT_EQ(maybe_result->size(), shard_count);
+    for (std::size_t i = 0; i != shard_count; ++i) {
+        EXPECT_EQ((*maybe_result)[i], i);
+    }
+}
+
+TEST(algo, whenAllRangeError) {
+    using result_type = meta::result<int, int>;
+    std::size_t emitted = 0;
+    const auto count = [&emitted](int x) {
+        ++emitted;
+        return x;
+    };
+
+    std::vector<decltype(as_signal(result_type{}) | map(count))> signals;
+    signals.push_back(as_signal(result_type{ 1 }) | map(count));
+    signals.push_back(as_signal(result_type{ tl::unexpect, 2 }) | map(count));
+    signals.push_back(as_signal(result_type{ 3 }) | map(count));
+
+    const auto maybe_result = when_all(std::span{ signals }) | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    ASSERT_FALSE(maybe_result->has_value());
+    EXPECT_EQ(maybe_result->error(), 2);
+    // the last one is not emitted, since the result is already decided
+    EXPECT_EQ(emitted, 1);
+
+    const auto maybe_empty = when_all(std::vector<decltype(as_signal(result_type{}))>{}) | get<nowait_event>();
+    ASSERT_TRUE(maybe_empty.has_value());
+    ASSERT_TRUE(maybe_empty->has_value());
+    EXPECT_TRUE(maybe_empty->value().empty());
+}
+
+TEST(algo, whenAnyRange) {
+    using result_type = meta::result<int, int>;
+    using signal_type = decltype(as_signal(result_type{}));
+
+    {
+        std::vector<signal_type> signals;
+        signals.push_back(as_signal(result_type{ tl::unexpect, 1 }));
+        signals.push_back(as_signal(result_type{ 2 }));
+        signals.push_back(as_signal(result_type{ 3 }));
+        const auto maybe_result = when_any(std::move(signals)) | get<nowait_event>();
+        ASSERT_TRUE(maybe_result.has_value());
+        EXPECT_EQ(*maybe_result, 2);
+    }
+    {
+        std::vector<signal_type> signals;
+        signals.push_back(as_signal(result_type{ tl::unexpect, 1 }));
+        signals.push_back(as_signal(result_type{ tl::unexpect, 2 }));
+        const auto maybe_result = when_any(std::move(signals)) | get<nowait_event>();
+        ASSERT_TRUE(maybe_result.has_value());
+        ASSERT_FALSE(maybe_result->has_value());
+        EXPECT_EQ(maybe_result->error(), 1);
+    }
+    {
+        const auto maybe_result = when_any(std::vector<signal_type>{}) | get<nowait_event>();
+        EXPECT_FALSE(maybe_result.has_value());
+    }
+}
+
+TEST(algo, mapConcurrent) {
+    manual_executor executor;
+    constexpr std::size_t item_count = 100;
+    constexpr std::size_t limit = 4;
+
+    std::vector<std::size_t> items(item_count);
+    std::iota(items.begin(), items.end(), 0);
+
+    std::size_t in_flight = 0;
+    std::size_t max_in_flight = 0;
+    meta::maybe<std::vector<std::size_t>> maybe_result;
+    map_concurrent(items, limit, [&](std::size_t item) {
+        max_in_flight = std::max(max_in_flight, ++in_flight);
+        return schedule(executor, [&in_flight, item] {
+            --in_flight;
+            return meta::ok(item * 2);
+        });
+    }) | map([&maybe_result](std::vector<std::size_t> result) {
+        maybe_result.emplace(std::move(result));
+        return meta::unit{};
+    }) | detach();
+    EXPECT_EQ(in_flight, limit);
+
+    while (executor.execute_batch() > 0) {}
+    EXPECT_EQ(max_in_flight, limit);
+    ASSERT_TRUE(maybe_result.has_value());
+    ASSERT_EQ(maybe_result->size(), item_count);
+    for (std::size_t i = 0; i != item_count; ++i) {
+        EXPECT_EQ((*maybe_result)[i], i * 2);
+    }
+}
+
+TEST(algo, mapConcurrentZeroLimit) {
+    manual_executor executor;
+    const std::vector<int> items{ 1, 2, 3 };
+
+    std::size_t in_flight = 0;
+    std::size_t max_in_flight = 0;
+    meta::maybe<std::vector<int>> maybe_result;
+    map_concurrent(items, 0, [&](int item) {
+        max_in_flight = std::max(max_in_flight, ++in_flight);
+        return schedule(executor, [&in_flight, item] {
+            --in_flight;
+            return meta::ok(item * 2);
+        });
+    }) | map([&maybe_result](std::vector<int> result) {
+        maybe_result.emplace(std::move(result));
+        return meta::unit{};
+    }) | detach();
+
+    // runs one at a time instead of never launching anything
+    while (executor.execute_batch() > 0) {}
+    EXPECT_EQ(max_in_flight, 1);
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(*maybe_result, (std::vector<int>{ 2, 4, 6 }));
+}
+
+TEST(algo, mapConcurrentCancelUncancellable) {
+    manual_executor executor;
+    std::size_t launched = 0;
+    bool is_done = false;
+    auto connection = map_concurrent(std::vector<int>{ 1, 2, 3 }, 1, [&](int item) {
+                          ++launched;
+                          return schedule(executor, [item] { return meta::ok(item * 2); });
+                      })
+                      | map([&is_done](std::vector<int>) {
+                            is_done = true;
+                            return meta::unit{};
+                        })
+                      | subscribe();
+    auto handle = std::move(connection).emit();
+    EXPECT_EQ(launched, 1);
+
+    // the scheduled child can't be cancelled and completes w/ a value, the rest are never launched
+    std::move(handle).try_cancel();
+    while (executor.execute_batch() > 0) {}
+    EXPECT_EQ(launched, 1);
+    EXPECT_FALSE(is_done);
+}
+
+TEST(algo, mapConcurrentError) {
+    using result_type = meta::result<int, meta::unit>;
+    auto channel = make_channel<int>();
+    channel->send(42) | detach();
+
+    std::size_t launched = 0;
+    bool is_failed = false;
+    for_each_concurrent(
+        std::vector<int>{ 0, 1, 2, 3, 4, 5 },
+        2,
+        [&](int item) {
+            ++launched;
+            return channel->receive() | and_then([item](int) {
+                       return item == 1 ? result_type{ tl::unexpect, meta::unit{} } : result_type{ item };
+                   });
+        }
+    ) | map_error([&is_failed](meta::unit) {
+        is_failed = true;
+        return meta::unit{};
+    }) | detach();
+    EXPECT_EQ(launched, 3);
+    EXPECT_FALSE(is_failed);
+
+    // the error stops launching and cancels the receive that is still in flight
+    channel->send(69) | detach();
+    EXPECT_TRUE(is_failed);
+    EXPECT_EQ(launched, 3);
+
+    channel->send(72) | detach();
+    const auto maybe_result = channel->receive() | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(maybe_result->value(), 72);
+}
+
+TEST(algo, parallelFor) {
+    manual_executor executor;
+    std::vector<int> items(100, 0);
+
+    meta::maybe<meta::unit> maybe_done;
+    parallel_for(executor, items, 8, [](int& x) { ++x; }) | map([&maybe_done](meta::unit) {
+        maybe_done.emplace();
+        return meta::unit{};
+    }) | detach();
+    EXPECT_FALSE(maybe_done.has_value());
+
+    while (executor.execute_batch() > 0) {}
+    EXPECT_TRUE(maybe_done.has_value());
+    EXPECT_TRUE(std::ranges::all_of(items, [](int x) { return x == 1; }));
+}
+
+TEST(algo, parallelForGrainFromExecutor) {
+    manual_executor executor;
+    std::vector<int> items(64, 0);
+
+    // a single-threaded executor gets a few chunks, not a few per hardware thread
+    parallel_for(executor, items, 0, [](int& x) { ++x; }) | detach();
+    std::size_t task_count = 0;
+    while (const std::size_t executed = executor.execute_batch()) {
+        task_count += executed;
+    }
+    EXPECT_EQ(task_count, 8);
+    EXPECT_TRUE(std::ranges::all_of(items, [](int x) { return x == 1; }));
+}
+
+TEST(algo, parallelReduceScan) {
+    manual_executor executor;
+    std::vector<int> items(1000);
+    std::iota(items.begin(), items.end(), 1);
+
+    meta::maybe<int> maybe_sum;
+    parallel_reduce(executor, items, 7, 0, std::plus<>{}) | map([&maybe_sum](int sum) {
+        maybe_sum.emplace(sum);
+        return meta::unit{};
+    }) | detach();
+
+    std::vector<int> prefixes(items.size());
+    bool is_scanned = false;
+    parallel_inclusive_scan(executor, items, prefixes, 0, std::plus<>{}) | map([&is_scanned](meta::unit) {
+        is_scanned = true;
+        return meta::unit{};
+    }) | detach();
+
+    while (executor.execute_batch() > 0) {}
+    ASSERT_TRUE(maybe_sum.has_value());
+    EXPECT_EQ(*maybe_sum, 1000 * 1001 / 2);
+    ASSERT_TRUE(is_scanned);
+    std::vector<int> expected(items.size());
+    std::inclusive_scan(items.begin(), items.end(), expected.begin());
+    EXPECT_EQ(prefixes, expected);
+}
+
+TEST(algo, parallelForCancel) {
+    manual_executor executor;
+    std::size_t processed = 0;
+    bool is_done = false;
+    auto connection = parallel_for(executor, std::views::iota(0, 64), 1, [&processed](int) { ++processed; })
+                      | map([&is_done](meta::unit) {
+                            is_done = true;
+                            return meta::unit{};
+                        })
+                      | subscribe();
+    auto handle = std::move(connection).emit();
+    executor.execute_at_most(1);
+
+    // the rest of the chunks are skipped
+    std::move(handle).try_cancel();
+    while (executor.execute_batch() > 0) {}
+    EXPECT_EQ(processed, 1);
+    EXPECT_FALSE(is_done);
+}
+
 TEST(algo, forkSimple) {
     auto [l_signal, r_signal] = value_as_signal(42) | fork();
     auto l_value = std::move(l_signal) | get<nowait_event>();
@@ -185,6 +487,25 @@ TEST(algo, forkSimple) {
     EXPECT_EQ(*r_value, 69);
 }
 
+TEST(algo, forkLateAndDropped) {
+    auto [future, promise] = exec::make_contract<int, meta::undefined>();
+    auto [early, dropped, late] = std::move(future) | fork<3>();
+
+    int sum = 0;
+    auto add = [&sum](int x) {
+        sum += x;
+        return meta::unit{};
+    };
+    std::move(early) | map(add) | detach();
+    { [[maybe_unused]] auto to_drop = std::move(dropped); }
+    EXPECT_EQ(sum, 0);
+
+    std::move(promise).set_value(42);
+    EXPECT_EQ(sum, 42);
+    std::move(late) | map(add) | detach();
+    EXPECT_EQ(sum, 84);
+}
+
 TEST(algo, force) {
     auto [future, promise] = exec::make_contract<int, meta::undefined>();
     std::move(promise).set_value(42);
@@ -337,6 +658,46 @@ TEST(algo, box) {
     EXPECT_EQ(maybe_result.value(), 69);
 }
 
+template <SomeSignal SignalT>
+using test_connection_for =
+    ConnectionFor<SignalT, dummy_slot_ctor<typename SignalT::value_type, typename SignalT::error_type>>;
+
+template <typename ConnectionT>
+void report_layout(std::string_view title) {
+    std::cout << title << ", allocations: " << layout_allocation_count_v<ConnectionT> << '\n';
+    layout_print(std::cout, layout_of<ConnectionT>());
+}
+
+TEST(algo, connectionLayout) {
+    const auto increment = [](int x) { return x + 1; };
+    const auto checked = [](int x) { return meta::result<int, meta::unit>{ x }; };
+
+    using map_type = test_connection_for<decltype(value_as_signal(0) | map(increment))>;
+    report_layout<map_type>("map");
+    constexpr auto map_layout = layout_of<map_type>();
+    static_assert(map_layout.size() == 3);
+    EXPECT_EQ(map_layout[2].name, "map_slot");
+    EXPECT_EQ(map_layout[2].padding, 0);
+
+    using chain_type = test_connection_for<decltype(
+        as_signal(meta::result<int, meta::unit>{ 0 }) | map(increment) | and_then(checked) | map(increment)
+        | and_then(checked)
+    )>;
+    report_layout<chain_type>("map | and_then | map | and_then");
+    EXPECT_EQ(layout_of<chain_type>()[0].name, "fused_connection");
+    EXPECT_EQ(layout_allocation_count_v<chain_type>, 0);
+
+    using all_type = test_connection_for<decltype(all(
+        as_signal(meta::result<int, meta::unit>{ 0 }) | map(increment),
+        as_signal(meta::result<int, meta::unit>{ 0 }) | and_then(checked)
+    ))>;
+    report_layout<all_type>("all");
+    constexpr auto all_layout = layout_of<all_type>();
+    EXPECT_EQ(layout_allocation_count_v<all_type>, 1);
+    EXPECT_TRUE(all_layout[1].is_allocated);
+    EXPECT_EQ(all_layout[1].name, "all_connection");
+}
+
 TEST(algo, channelSimple) {
     auto channel = make_channel<int>();
 
@@ -373,6 +734,92 @@ TEST(algo, channelSimple) {
     }
 }
 
+TEST(algo, streamPipeline) {
+    const std::vector<int> input{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    std::size_t mapped = 0;
+    const auto maybe_result = as_stream(input) //
+                              | filter([](const int& x) { return x % 2 == 0; })
+                              | map([&mapped](int x) {
+                                    ++mapped;
+                                    return x * 10;
+                                })
+                              | take(3) | collect() | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(maybe_result.value(), (std::vector<int>{ 20, 40, 60 }));
+    EXPECT_EQ(mapped, 3);
+}
+
+TEST(algo, streamBatchZero) {
+    // batches of one instead of never requesting anything
+    const auto maybe_result = as_stream(std::vector<int>{ 1, 2, 3 }) | batch(0) | collect() | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(maybe_result.value(), (std::vector<std::vector<int>>{ { 1 }, { 2 }, { 3 } }));
+}
+
+TEST(algo, streamBatchMerge) {
+    {
+        const auto maybe_result = as_stream(std::vector<int>{ 1, 2, 3, 4, 5 }) | batch(2) | collect()
+                                  | get<nowait_event>();
+        ASSERT_TRUE(maybe_result.has_value());
+        EXPECT_EQ(
+            maybe_result.value(), (std::vector<std::vector<int>>{ { 1, 2 }, { 3, 4 }, { 5 } })
+        );
+    }
+    {
+        auto maybe_result = merge(as_stream(std::vector<int>{ 1, 3, 5 }), as_stream(std::vector<int>{ 2, 4 }))
+                            | collect() | get<nowait_event>();
+        ASSERT_TRUE(maybe_result.has_value());
+        std::vector<int> result = std::move(maybe_result).value().value();
+        std::ranges::sort(result);
+        EXPECT_EQ(result, (std::vector<int>{ 1, 2, 3, 4, 5 }));
+    }
+}
+
+TEST(algo, streamChannel) {
+    auto channel = make_channel<int>();
+    std::vector<int> received;
+    bool is_done = false;
+    as_stream(*channel) | for_each([&received](int x) { received.push_back(x); })
+        | map([&is_done](meta::unit) {
+              is_done = true;
+              return meta::unit{};
+          })
+        | detach();
+
+    for (int i = 0; i != 3; ++i) {
+        channel->send(int{ i }) | detach();
+    }
+    EXPECT_EQ(received, (std::vector<int>{ 0, 1, 2 }));
+    EXPECT_FALSE(is_done);
+
+    channel->close() | detach();
+    EXPECT_TRUE(is_done);
+}
+
+TEST(algo, streamTakeCancelsUpstream) {
+    auto channel = make_channel<int>();
+    std::vector<int> received;
+    bool is_done = false;
+    as_stream(*channel) | take(2) | for_each([&received](int x) { received.push_back(x); })
+        | map([&is_done](meta::unit) {
+              is_done = true;
+              return meta::unit{};
+          })
+        | detach();
+
+    channel->send(1) | detach();
+    EXPECT_FALSE(is_done);
+    channel->send(2) | detach();
+    EXPECT_TRUE(is_done);
+    EXPECT_EQ(received, (std::vector<int>{ 1, 2 }));
+
+    // nothing is received past the second value, so it stays in the channel
+    channel->send(3) | detach();
+    const auto maybe_result = channel->receive() | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(maybe_result.value(), 3);
+}
+
 TEST(algo, selectAsAny) {
     manual_executor executor;
     std::size_t counter1 = 0;
@@ -783,4 +1230,625 @@ TEST(algo, selectSingleChannelWithDefault) {
     EXPECT_EQ(default_counter, 2);
 }
 
+TEST(algo, serialOrder) {
+    manual_executor executor;
+    serial_executor serial{ executor };
+
+    std::vector<int> order;
+    for (int i = 0; i != 5; ++i) {
+        start_on(serial) //
+            | map([&order, i](meta::unit) {
+                  order.push_back(i);
+                  return meta::unit{};
+              })
+            | detach();
+    }
+
+    EXPECT_EQ(executor.execute_batch(), 1);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+
+    const serial_executor_stats stats = serial.stats();
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_EQ(stats.runs, 1);
+    EXPECT_EQ(stats.executed, 5);
+    EXPECT_EQ(stats.yields, 0);
+}
+
+TEST(algo, serialBudget) {
+    manual_executor executor;
+    serial_executor serial{ executor, serial_executor_budget{ .max_tasks = 2 } };
+
+    std::vector<int> order;
+    for (int i = 0; i != 5; ++i) {
+        start_on(serial) //
+            | map([&order, i](meta::unit) {
+                  order.push_back(i);
+                  return meta::unit{};
+              })
+            | detach();
+    }
+
+    EXPECT_EQ(executor.execute_at_most(1), 1);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(serial.stats().queue_depth, 3);
+    EXPECT_EQ(serial.stats().yields, 1);
+
+    // strand went back into the queue of the underlying executor
+    EXPECT_EQ(executor.execute_at_most(1), 1);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3 }));
+
+    EXPECT_EQ(executor.execute_at_most(1), 1);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+
+    const serial_executor_stats stats = serial.stats();
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_EQ(stats.runs, 3);
+    EXPECT_EQ(stats.executed, 5);
+    EXPECT_EQ(stats.yields, 2);
+    EXPECT_EQ(executor.execute_batch(), 0);
+}
+
+TEST(algo, sharedMutexReaders) {
+    manual_executor executor;
+    shared_mutex mutex{ executor };
+    using shared_lock = shared_mutex_lock<detail::atomic, shared_mutex_mode::shared>;
+
+    std::vector<shared_lock> locks;
+    for (int i = 0; i != 3; ++i) {
+        mutex.lock_shared() //
+            | map([&locks](shared_lock lock) {
+                  locks.push_back(std::move(lock));
+                  return meta::unit{};
+              })
+            | detach();
+    }
+
+    // strand run grants all readers, then their continuations run on the executor
+    EXPECT_EQ(executor.execute_batch(), 1);
+    EXPECT_EQ(executor.execute_batch(), 3);
+    EXPECT_EQ(locks.size(), 3);
+
+    for (shared_lock& lock : locks) {
+        std::move(lock).unlock() | detach();
+    }
+    EXPECT_EQ(executor.execute_batch(), 1);
+    EXPECT_EQ(executor.execute_batch(), 0);
+}
+
+TEST(algo, sharedMutexWriterPreference) {
+    manual_executor executor;
+    shared_mutex mutex{ executor };
+    using shared_lock = shared_mutex_lock<detail::atomic, shared_mutex_mode::shared>;
+    using exclusive_lock = shared_mutex_lock<detail::atomic, shared_mutex_mode::exclusive>;
+
+    std::vector<std::string> order;
+    std::vector<shared_lock> shared_locks;
+    std::vector<exclusive_lock> exclusive_locks;
+
+    const auto lock_shared = [&](std::string name) {
+        mutex.lock_shared() //
+            | map([&, name = std::move(name)](shared_lock lock) {
+                  order.push_back(name);
+                  shared_locks.push_back(std::move(lock));
+                  return meta::unit{};
+              })
+            | detach();
+    };
+    const auto lock = [&](std::string name) {
+        mutex.lock() //
+            | map([&, name = std::move(name)](exclusive_lock lock) {
+                  order.push_back(name);
+                  exclusive_locks.push_back(std::move(lock));
+                  return meta::unit{};
+              })
+            | detach();
+    };
+    const auto unlock_all = [&] {
+        for (shared_lock& lock : std::exchange(shared_locks, {})) {
+            std::move(lock).unlock() | detach();
+        }
+        for (exclusive_lock& lock : std::exchange(exclusive_locks, {})) {
+            std::move(lock).unlock() | detach();
+        }
+    };
+    const auto drain = [&] {
+        while (executor.execute_batch() > 0) {}
+    };
+
+    lock_shared("r0");
+    drain();
+    EXPECT_EQ(order, (std::vector<std::string>{ "r0" }));
+
+    // readers arriving after a waiting writer do not barge past it
+    lock("w0");
+    lock_shared("r1");
+    lock_shared("r2");
+    lock("w1");
+    drain();
+    EXPECT_EQ(order, (std::vector<std::string>{ "r0" }));
+
+    unlock_all();
+    drain();
+    EXPECT_EQ(order, (std::vector<std::string>{ "r0", "w0" }));
+
+    // released writer admits the queued readers as one batch before the next writer
+    unlock_all();
+    drain();
+    EXPECT_EQ(order, (std::vector<std::string>{ "r0", "w0", "r1", "r2" }));
+    EXPECT_EQ(shared_locks.size(), 2);
+
+    unlock_all();
+    drain();
+    EXPECT_EQ(order, (std::vector<std::string>{ "r0", "w0", "r1", "r2", "w1" }));
+
+    unlock_all();
+    drain();
+}
+
+TEST(algo, semaphoreFifo) {
+    semaphore sem{ 2 };
+
+    std::vector<int> order;
+    const auto acquire = [&](int id, std::size_t count) {
+        sem.acquire(count) //
+            | map([&order, id](meta::unit) {
+                  order.push_back(id);
+                  return meta::unit{};
+              })
+            | detach();
+    };
+
+    acquire(0, 1);
+    acquire(1, 1);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(sem.available(), 0);
+
+    // head of the queue wants more than is released, the smaller waiter behind it does not overtake
+    acquire(2, 2);
+    acquire(3, 1);
+    EXPECT_FALSE(sem.try_acquire());
+    sem.release();
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1 }));
+    sem.release(2);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_EQ(sem.available(), 0);
+
+    sem.release(4);
+    EXPECT_TRUE(sem.try_acquire(4));
+}
+
+TEST(algo, semaphoreCancel) {
+    semaphore sem{ 0 };
+
+    bool is_acquired = false;
+    auto head = sem.acquire(2) //
+        | map([&is_acquired](meta::unit) {
+              is_acquired = true;
+              return meta::unit{};
+          })
+        | subscribe();
+    auto head_handle = std::move(head).emit();
+
+    int tail_acquired = 0;
+    sem.acquire(1) //
+        | map([&tail_acquired](meta::unit) {
+              ++tail_acquired;
+              return meta::unit{};
+          })
+        | detach();
+
+    sem.release();
+    EXPECT_EQ(tail_acquired, 0);
+
+    // cancelled head unblocks the waiter behind it
+    std::move(head_handle).try_cancel();
+    EXPECT_FALSE(is_acquired);
+    EXPECT_EQ(tail_acquired, 1);
+    EXPECT_EQ(sem.available(), 0);
+}
+
+TEST(algo, allNullDuringEmit) {
+    semaphore sem{ 0 };
+    const auto maybe_result = all(null_as_signal(), sem.acquire(1)) | get<nowait_event>();
+    EXPECT_FALSE(maybe_result.has_value());
+
+    // the null came before the waiter was emitted, so it's cancelled by the emitter
+    sem.release();
+    EXPECT_EQ(sem.available(), 1);
+}
+
+TEST(algo, parallelContinueOnExecutor) {
+    manual_executor executor;
+
+    std::vector<int> order;
+    all_<detail::atomic>(executor)(value_as_signal(1), value_as_signal(2)) //
+        | map([&order](std::tuple<int, int> values) {
+              order.push_back(std::get<0>(values) + std::get<1>(values));
+              return meta::unit{};
+          })
+        | detach();
+    any_<detail::atomic>(executor)(value_as_signal(4), value_as_signal(5)) //
+        | map([&order](int value) {
+              order.push_back(value);
+              return meta::unit{};
+          })
+        | detach();
+    select(executor)
+            .case_(as_signal(meta::result<int, meta::unit>{ 6 }), [](int value) { return value; })
+            .case_(as_signal(meta::result<int, meta::unit>{ 7 }), [](int value) { return value; })
+        | map([&order](int value) {
+              order.push_back(value);
+              return meta::unit{};
+          })
+        | detach();
+
+    // every result is ready inline, but the continuations are scheduled onto the given executor
+    EXPECT_TRUE(order.empty());
+    EXPECT_EQ(executor.execute_batch(), 3);
+    EXPECT_EQ(order, (std::vector<int>{ 3, 4, 6 }));
+}
+
+TEST(algo, cancelPropagationAll) {
+    semaphore sem{ 0 };
+    bool is_done = false;
+    auto connection = all(sem.acquire(1), sem.acquire(1)) //
+                      | map([&is_done](auto&&) {
+                            is_done = true;
+                            return meta::unit{};
+                        })
+                      | subscribe();
+    auto handle = std::move(connection).emit();
+
+    // both waiters are dequeued, so the permits are left intact
+    std::move(handle).try_cancel();
+    sem.release(2);
+    EXPECT_FALSE(is_done);
+    EXPECT_EQ(sem.available(), 2);
+}
+
+TEST(algo, cancelPropagationWhenAny) {
+    semaphore sem{ 0 };
+    std::vector<decltype(sem.acquire(1))> signals;
+    signals.push_back(sem.acquire(1));
+    signals.push_back(sem.acquire(1));
+    auto connection = when_any(std::move(signals)) | subscribe();
+    auto handle = std::move(connection).emit();
+
+    std::move(handle).try_cancel();
+    sem.release(1);
+    EXPECT_EQ(sem.available(), 1);
+}
+
+TEST(algo, cancelPropagationFlatten) {
+    semaphore sem{ 0 };
+    bool is_done = false;
+    auto connection = value_as_signal(1) //
+                      | map([&sem](int) { return sem.acquire(1); })
+                      | flatten()
+                      | map([&is_done](meta::unit) {
+                            is_done = true;
+                            return meta::unit{};
+                        })
+                      | subscribe();
+    auto handle = std::move(connection).emit();
+
+    // the inner signal is already waiting
+    std::move(handle).try_cancel();
+    sem.release(1);
+    EXPECT_FALSE(is_done);
+    EXPECT_EQ(sem.available(), 1);
+}
+
+TEST(algo, cancelPropagationForce) {
+    semaphore sem{ 0 };
+    bool is_done = false;
+    auto connection = sem.acquire(1) //
+                      | force()
+                      | map([&is_done](meta::unit) {
+                            is_done = true;
+                            return meta::unit{};
+                        })
+                      | subscribe();
+    auto handle = std::move(connection).emit();
+
+    std::move(handle).try_cancel();
+    sem.release(1);
+    EXPECT_FALSE(is_done);
+    EXPECT_EQ(sem.available(), 1);
+}
+
+TEST(algo, cancellationCallback) {
+    cancellation_source<> source;
+    int counter = 0;
+    {
+        const cancellation_callback deregistered{ source.token(), [&counter] { counter += 100; } };
+    }
+    const cancellation_callback callback{ source.token(), [&counter] { ++counter; } };
+    EXPECT_FALSE(source.is_cancel_requested());
+
+    EXPECT_TRUE(source.request_cancel());
+    EXPECT_FALSE(source.request_cancel());
+    EXPECT_TRUE(source.is_cancel_requested());
+    EXPECT_EQ(counter, 1);
+
+    // too late to register, invoked inline
+    const cancellation_callback late{ source.token(), [&counter] { ++counter; } };
+    EXPECT_EQ(counter, 2);
+}
+
+TEST(algo, withCancellation) {
+    cancellation_source<> source;
+    semaphore sem{ 0 };
+    auto channel = make_channel<int>();
+    auto other_channel = make_channel<int>();
+
+    int counter = 0;
+    const auto increment = [&counter](auto&&) {
+        ++counter;
+        return meta::unit{};
+    };
+
+    // completes before the request, so it's deregistered right away
+    value_as_signal(1) | with_cancellation(source.token()) | map(increment) | detach();
+    EXPECT_EQ(counter, 1);
+
+    sem.acquire(1) | with_cancellation(source.token()) | map(increment) | detach();
+    channel->receive() | with_cancellation(source.token()) | map(increment) | detach();
+    select() //
+            .case_(channel->receive(), increment)
+            .case_(other_channel->receive(), increment)
+        | with_cancellation(source.token()) | detach();
+
+    EXPECT_TRUE(source.request_cancel());
+    EXPECT_EQ(counter, 1);
+
+    // nothing is left waiting
+    sem.release();
+    EXPECT_EQ(sem.available(), 1);
+    channel->send(42) | detach();
+    const auto maybe_result = channel->receive() | get<nowait_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    EXPECT_EQ(maybe_result->value(), 42);
+
+    // already cancelled, so it's not even emitted
+    sem.acquire(1) | with_cancellation(source.token()) | map(increment) | detach();
+    EXPECT_EQ(counter, 1);
+    EXPECT_EQ(sem.available(), 1);
+}
+
+TEST(algo, rateLimiterRefill) {
+    using namespace std::chrono_literals;
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start{};
+    rate_limiter<clock> limiter{ 2, 10ms, start };
+
+    EXPECT_TRUE(limiter.try_acquire(2));
+    EXPECT_FALSE(limiter.try_acquire());
+
+    int acquired = 0;
+    for (int i = 0; i != 3; ++i) {
+        limiter.acquire() //
+            | map([&acquired](meta::unit) {
+                  ++acquired;
+                  return meta::unit{};
+              })
+            | detach();
+    }
+    EXPECT_EQ(acquired, 0);
+
+    EXPECT_EQ(limiter.refill(start + 5ms), 0);
+    EXPECT_EQ(limiter.refill(start + 15ms), 1);
+    EXPECT_EQ(acquired, 1);
+    EXPECT_EQ(limiter.next_refill(), start + 20ms);
+
+    EXPECT_EQ(limiter.refill(start + 40ms), 2);
+    EXPECT_EQ(acquired, 3);
+
+    // full bucket does not accumulate idle time
+    EXPECT_EQ(limiter.refill(start + 1s), 2);
+    EXPECT_EQ(limiter.available(), 2);
+    EXPECT_EQ(limiter.next_refill(), start + 1s + 10ms);
+}
+
+TEST(algo, mutexUncontendedInline) {
+    manual_executor executor;
+    mutex m{ executor };
+
+    bool is_locked = false;
+    m.lock() //
+        | map([&is_locked](mutex_lock lock) {
+              is_locked = true;
+              return std::move(lock).unlock();
+          })
+        | flatten() //
+        | detach();
+
+    // neither lock nor unlock needs an executor round-trip
+    EXPECT_TRUE(is_locked);
+    EXPECT_EQ(executor.execute_batch(), 0);
+}
+
+TEST(algo, mutexHandoff) {
+    manual_executor executor;
+    mutex m{ executor };
+
+    std::vector<int> order;
+    std::vector<mutex_lock> locks;
+    for (int i = 0; i != 3; ++i) {
+        m.lock() //
+            | map([&order, &locks, i](mutex_lock lock) {
+                  order.push_back(i);
+                  locks.push_back(std::move(lock));
+                  return meta::unit{};
+              })
+            | detach();
+    }
+    EXPECT_EQ(order, (std::vector<int>{ 0 }));
+    EXPECT_EQ(executor.execute_batch(), 0);
+
+    // each unlock hands the lock off to exactly one waiter in arrival order
+    for (int expected = 1; expected != 3; ++expected) {
+        std::move(locks.back()).unlock() | detach();
+        EXPECT_EQ(executor.execute_batch(), 1);
+        EXPECT_EQ(order.back(), expected);
+    }
+
+    std::move(locks.back()).unlock() | detach();
+    EXPECT_EQ(executor.execute_batch(), 0);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2 }));
+
+    bool is_relocked = false;
+    m.lock() //
+        | map([&is_relocked](mutex_lock lock) {
+              is_relocked = true;
+              return std::move(lock).unlock();
+          })
+        | flatten() //
+        | detach();
+    EXPECT_TRUE(is_relocked);
+    EXPECT_EQ(executor.execute_batch(), 0);
+}
+
+TEST(algo, mutexUnlockOnEmit) {
+    manual_executor executor;
+    mutex m{ executor };
+
+    meta::maybe<mutex_lock> maybe_lock;
+    m.lock() //
+        | map([&maybe_lock](mutex_lock lock) {
+              maybe_lock.emplace(std::move(lock));
+              return meta::unit{};
+          })
+        | detach();
+    ASSERT_TRUE(maybe_lock.has_value());
+
+    bool is_next_locked = false;
+    m.lock() //
+        | map([&is_next_locked](mutex_lock lock) {
+              is_next_locked = true;
+              return std::move(lock).unlock();
+          })
+        | flatten() //
+        | detach();
+
+    // building the unlock signal doesn't release the lock yet
+    auto unlock_signal = std::move(maybe_lock).value().unlock();
+    maybe_lock.reset();
+    EXPECT_EQ(executor.execute_batch(), 0);
+    EXPECT_FALSE(is_next_locked);
+
+    std::move(unlock_signal) | detach();
+    EXPECT_EQ(executor.execute_batch(), 1);
+    EXPECT_TRUE(is_next_locked);
+}
+
+TEST(algo, runLoopRunOnce) {
+    run_loop_executor executor{ run_loop_config{ .with_eventfd = true } };
+
+    std::vector<int> order;
+    for (int i = 0; i != 3; ++i) {
+        schedule(executor, [&order, i] -> meta::result<meta::unit, meta::undefined> {
+            order.push_back(i);
+            return meta::ok(meta::unit{});
+        }) | detach();
+    }
+
+    EXPECT_EQ(executor.run_once(), 3);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2 }));
+    EXPECT_EQ(executor.run_once(), 0);
+
+    // wakes up immediately, since the task is already there
+    bool done = false;
+    start_on(executor) //
+        | map([&done](meta::unit) {
+              done = true;
+              return meta::unit{};
+          })
+        | detach();
+    EXPECT_EQ(executor.run_until([&done] { return done; }), 1);
+    EXPECT_EQ(executor.run_for(std::chrono::milliseconds{ 1 }), 0);
+}
+
+TEST(algo, trampolineDepth) {
+    constexpr std::size_t max_depth = 8;
+    trampoline_executor executor{ max_depth };
+
+    struct recursive_task final : task_node {
+        trampoline_executor& executor;
+        std::size_t remaining;
+        std::size_t executed = 0;
+        std::size_t observed_depth = 0;
+
+        recursive_task(trampoline_executor& executor, std::size_t remaining)
+            : executor{ executor }, remaining{ remaining } {}
+
+        void execute() noexcept override {
+            ++executed;
+            observed_depth = std::max(observed_depth, trampoline_executor::current_depth());
+            if (--remaining > 0) {
+                executor.schedule(*this);
+            }
+        }
+        void cancel() noexcept override {}
+    };
+
+    // would overflow the stack w/o trampolining
+    recursive_task task{ executor, 1'000'000 };
+    executor.schedule(task);
+    EXPECT_EQ(task.executed, 1'000'000);
+    EXPECT_EQ(task.observed_depth, max_depth);
+    EXPECT_EQ(trampoline_executor::current_depth(), 0);
+}
+
+TEST(algo, trampolineOrder) {
+    trampoline_executor executor{ 1 };
+
+    std::vector<int> order;
+    std::size_t observed_depth = 0;
+    const auto record = [&order, &observed_depth](int id) {
+        order.push_back(id);
+        observed_depth = std::max(observed_depth, trampoline_executor::current_depth());
+    };
+
+    start_on(executor) //
+        | map([&](meta::unit) {
+              for (int i = 1; i != 4; ++i) {
+                  // past max_depth, deferred until the outermost task is done
+                  start_on(executor) //
+                      | map([&, i](meta::unit) {
+                            start_on(executor) //
+                                | map([&record, i](meta::unit) {
+                                      record(10 + i);
+                                      return meta::unit{};
+                                  })
+                                | detach();
+                            record(i);
+                            return meta::unit{};
+                        })
+                      | detach();
+              }
+              record(0);
+              return meta::unit{};
+          })
+        | detach();
+
+    // inline executor would have nested them: 11, 1, 12, 2, 13, 3, 0
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3, 11, 12, 13 }));
+    EXPECT_EQ(observed_depth, 1);
+    EXPECT_EQ(trampoline_executor::current_depth(), 0);
+}
+
+TEST(algo, trampolineZeroDepth) {
+    trampoline_executor executor{ 0 };
+
+    bool done = false;
+    start_on(executor) //
+        | map([&done](meta::unit) {
+              done = true;
+              return meta::unit{};
+          })
+        | detach();
+    EXPECT_TRUE(done);
+}
+
 } // namespace sl::exec
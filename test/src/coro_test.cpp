@@ -402,6 +402,26 @@ TEST(coro, awaitVoid) {
     coro_schedule(exec::inline_executor(), coro());
 }
 
+TEST(coro, awaitWithCancellation) {
+    cancellation_source<> source;
+    auto channel = make_channel<int>();
+    bool is_resumed = false;
+    bool is_destroyed = false;
+
+    auto coro = [&] -> async<void> {
+        const meta::defer on_destroy{ [&is_destroyed] { is_destroyed = true; } };
+        std::ignore = co_await (channel->receive() | with_cancellation(source.token()));
+        is_resumed = true;
+    };
+    coro_schedule(exec::inline_executor(), coro());
+    EXPECT_FALSE(is_destroyed);
+
+    // observed as null, so the frame is destroyed w/o being resumed
+    source.request_cancel();
+    EXPECT_FALSE(is_resumed);
+    EXPECT_TRUE(is_destroyed);
+}
+
 TEST(coro, asSignal) {
     using exec::operator|;
     {
@@ -436,4 +456,42 @@ TEST(coro, asSignal) {
     }
 }
 
+TEST(coro, asyncGenAsStream) {
+    using exec::operator|;
+    {
+        manual_executor executor;
+        std::size_t pulled = 0;
+        auto gen = [&executor, &pulled] -> async_gen<std::size_t> {
+            for (std::size_t i = 0;; ++i) {
+                co_await start_on(executor);
+                ++pulled;
+                co_yield i;
+            }
+        };
+
+        std::vector<std::size_t> result;
+        as_stream(gen()) | take(3) | collect() | map([&result](std::vector<std::size_t> values) {
+            result = std::move(values);
+            return meta::unit{};
+        }) | detach();
+        while (executor.execute_batch() > 0) {}
+
+        EXPECT_EQ(result, (std::vector<std::size_t>{ 0, 1, 2 }));
+        EXPECT_EQ(pulled, 3);
+    }
+
+    {
+        auto gen = [] -> async_gen<int> {
+            co_yield 42;
+            throw std::runtime_error{ "hehe" };
+        };
+        std::vector<int> values;
+        auto maybe_result = as_stream(gen()) | for_each([&values](int x) { values.push_back(x); })
+                            | get<nowait_event>();
+        ASSERT_TRUE(maybe_result.has_value());
+        EXPECT_FALSE(maybe_result.value().has_value());
+        EXPECT_EQ(values, (std::vector<int>{ 42 }));
+    }
+}
+
 } // namespace sl::exec
@@ -5,13 +5,24 @@
 #include "sl/exec/algo.hpp"
 #include "sl/exec/model.hpp"
 #include "sl/exec/thread.hpp"
+#include "sl/exec/thread/detail/arc.hpp"
+#include "sl/exec/thread/detail/futex.hpp"
+#include "sl/exec/thread/detail/hazard_ptr.hpp"
+#include "sl/exec/thread/detail/lock_free_stack.hpp"
+#include "sl/exec/thread/detail/mpsc_queue.hpp"
 #include "sl/exec/thread/detail/multiword.hpp"
 #include "sl/exec/thread/detail/multiword_dcss.hpp"
 #include "sl/exec/thread/detail/multiword_kcas.hpp"
 #include "sl/exec/thread/detail/tagged_ptr.hpp"
+#include "sl/exec/thread/detail/trace.hpp"
+#include "sl/exec/thread/detail/unbound_blocking_queue.hpp"
 
 #include <gtest/gtest.h>
 
+#include <numeric>
+#include <ranges>
+#include <sstream>
+
 namespace sl::exec {
 
 TEST(thread, monolithicThreadPool) {
@@ -25,6 +36,378 @@ TEST(thread, monolithicThreadPool) {
     ASSERT_NE(*maybe_result, std::this_thread::get_id());
 }
 
+TEST(thread, monolithicThreadPoolWaitIdle) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    detail::atomic<std::size_t> counter{ 0 };
+
+    constexpr std::size_t outer_count = 100;
+    constexpr std::size_t inner_count = 10;
+    for (std::size_t i = 0; i != outer_count; ++i) {
+        schedule(
+            background_executor,
+            [&] -> meta::result<meta::unit, meta::undefined> {
+                for (std::size_t j = 0; j != inner_count; ++j) {
+                    schedule(
+                        background_executor,
+                        [&] -> meta::result<meta::unit, meta::undefined> {
+                            counter.fetch_add(1, std::memory_order::relaxed);
+                            return meta::ok(meta::unit{});
+                        }
+                    ) | detach();
+                }
+                counter.fetch_add(1, std::memory_order::relaxed);
+                return meta::ok(meta::unit{});
+            }
+        ) | detach();
+    }
+
+    background_executor.wait_idle();
+    ASSERT_EQ(counter.load(), outer_count * (inner_count + 1));
+}
+
+TEST(thread, serialExecutorExclusive) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    serial_executor serial{ background_executor, serial_executor_budget{ .max_tasks = 16 } };
+
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 1'000;
+    std::size_t counter = 0;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i != iterations; ++i) {
+                schedule(serial, [&counter] -> meta::result<meta::unit, meta::undefined> {
+                    ++counter;
+                    return meta::ok(meta::unit{});
+                }) | detach();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    background_executor.wait_idle();
+
+    ASSERT_EQ(counter, thread_count * iterations);
+    ASSERT_EQ(serial.stats().executed, thread_count * iterations);
+}
+
+TEST(thread, mutexExclusive) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    mutex m{ background_executor };
+
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 1'000;
+    std::size_t counter = 0;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i != iterations; ++i) {
+                m.lock() //
+                    | map([&counter](mutex_lock lock) {
+                          ++counter;
+                          return std::move(lock).unlock();
+                      })
+                    | flatten() //
+                    | detach();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    background_executor.wait_idle();
+
+    ASSERT_EQ(counter, thread_count * iterations);
+}
+
+TEST(thread, runLoopExecutor) {
+    run_loop_executor executor;
+
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 1'000;
+    std::size_t counter = 0;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i != iterations; ++i) {
+                schedule(executor, [&counter] -> meta::result<meta::unit, meta::undefined> {
+                    ++counter;
+                    return meta::ok(meta::unit{});
+                }) | detach();
+            }
+        });
+    }
+
+    // only the owner runs tasks, so counter is not shared
+    const std::size_t executed = executor.run_until([&counter] { return counter == thread_count * iterations; });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(executed, thread_count * iterations);
+}
+
+TEST(thread, monolithicThreadPoolMetrics) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(2u) };
+
+    constexpr std::size_t task_count = 100;
+    for (std::size_t i = 0; i != task_count; ++i) {
+        schedule(background_executor, [] -> meta::result<meta::unit, meta::undefined> {
+            return meta::ok(meta::unit{});
+        }) | detach();
+    }
+    background_executor.wait_idle();
+
+    const executor_metrics_snapshot snapshot = background_executor.metrics();
+#if SL_EXEC_METRICS
+    EXPECT_EQ(snapshot.queue_depth, 0);
+    EXPECT_EQ(snapshot.scheduled, task_count);
+    EXPECT_EQ(snapshot.executed, task_count);
+    EXPECT_EQ(snapshot.schedule_to_execute.count, task_count);
+    EXPECT_EQ(snapshot.execute_duration.count, task_count);
+    EXPECT_LE(snapshot.execute_duration.quantile(0.5), snapshot.execute_duration.quantile(0.99));
+#else
+    EXPECT_EQ(snapshot.scheduled, 0);
+    EXPECT_EQ(snapshot.executed, 0);
+    EXPECT_EQ(snapshot.schedule_to_execute.count, 0);
+#endif
+}
+
+TEST(thread, traceExportChrome) {
+    trace_clear();
+
+    manual_executor executor;
+    start_on(executor) //
+        | map([](meta::unit) { return meta::unit{}; })
+        | detach();
+    start_on(executor) //
+        | map([](meta::unit) { return meta::unit{}; })
+        | and_then([](meta::unit) -> meta::result<meta::unit, meta::undefined> { return meta::ok(meta::unit{}); })
+        | detach();
+    executor.execute_batch();
+
+    std::ostringstream os;
+    trace_export_chrome(os);
+    const std::string trace = os.str();
+    EXPECT_TRUE(trace.starts_with("{\"traceEvents\":["));
+    EXPECT_TRUE(trace.ends_with("]}"));
+#if SL_EXEC_TRACE
+    EXPECT_NE(trace.find("\"name\":\"schedule\",\"cat\":\"manual\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"execute\",\"cat\":\"manual\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"set_value\",\"cat\":\"detach\""), std::string::npos);
+    // fused stages keep their names
+    EXPECT_NE(trace.find("\"name\":\"set_value\",\"cat\":\"map|and_then\""), std::string::npos);
+
+    // microseconds w/ a fixed 3-digit fraction, never in scientific notation
+    const std::size_t ts = trace.find("\"ts\":");
+    ASSERT_NE(ts, std::string::npos);
+    const std::size_t dot = trace.find_first_not_of("0123456789", ts + 5);
+    ASSERT_EQ(trace[dot], '.');
+    EXPECT_EQ(trace.find_first_not_of("0123456789", dot + 1), dot + 4);
+
+    trace_clear();
+    std::ostringstream cleared_os;
+    trace_export_chrome(cleared_os);
+    EXPECT_EQ(cleared_os.str(), "{\"traceEvents\":[]}");
+#else
+    EXPECT_EQ(trace, "{\"traceEvents\":[]}");
+#endif
+}
+
+TEST(thread, whenAllScatterGather) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    constexpr std::size_t shard_count = 500;
+
+    const auto query = [&background_executor](std::size_t shard) {
+        return schedule(background_executor, [shard] -> meta::result<std::size_t, meta::undefined> {
+            return shard * shard;
+        });
+    };
+    std::vector<decltype(query(0))> signals;
+    for (std::size_t i = 0; i != shard_count; ++i) {
+        signals.push_back(query(i));
+    }
+
+    const auto maybe_result = when_all(std::move(signals)) | get<default_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    const std::vector<std::size_t>& result = maybe_result->value();
+    ASSERT_EQ(result.size(), shard_count);
+    for (std::size_t i = 0; i != shard_count; ++i) {
+        EXPECT_EQ(result[i], i * i);
+    }
+
+    std::vector<decltype(query(0))> any_signals;
+    for (std::size_t i = 0; i != shard_count; ++i) {
+        any_signals.push_back(query(i));
+    }
+    const auto maybe_any = when_any(std::move(any_signals)) | get<default_event>();
+    ASSERT_TRUE(maybe_any.has_value());
+    ASSERT_TRUE(maybe_any->has_value());
+
+    background_executor.wait_idle();
+}
+
+TEST(thread, cancellationRace) {
+    constexpr std::size_t iterations = 2'000;
+    for (std::size_t i = 0; i != iterations; ++i) {
+        cancellation_source<> source;
+        semaphore sem{ 0 };
+        std::atomic<bool> is_acquired = false;
+        sem.acquire(1) | with_cancellation(source.token()) | map([&is_acquired](meta::unit) {
+            is_acquired.store(true, std::memory_order::relaxed);
+            return meta::unit{};
+        }) | detach();
+
+        std::thread canceller{ [&source] { source.request_cancel(); } };
+        sem.release();
+        canceller.join();
+
+        // either acquired or dequeued, but never both
+        EXPECT_EQ(sem.available(), is_acquired.load(std::memory_order::relaxed) ? 0 : 1);
+    }
+}
+
+TEST(thread, mapConcurrent) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    constexpr std::size_t item_count = 10'000;
+    constexpr std::size_t limit = 8;
+
+    std::atomic<std::size_t> in_flight = 0;
+    std::atomic<std::size_t> max_in_flight = 0;
+    const auto maybe_result = map_concurrent(
+                                  std::views::iota(std::size_t{ 0 }, item_count),
+                                  limit,
+                                  [&](std::size_t item) {
+                                      const std::size_t current = in_flight.fetch_add(1) + 1;
+                                      std::size_t max = max_in_flight.load();
+                                      while (max < current && !max_in_flight.compare_exchange_weak(max, current)) {}
+                                      return schedule(background_executor, [&in_flight, item] {
+                                          in_flight.fetch_sub(1);
+                                          return meta::ok(item * item);
+                                      });
+                                  }
+                              )
+                              | get<default_event>();
+    ASSERT_TRUE(maybe_result.has_value());
+    const std::vector<std::size_t>& result = maybe_result->value();
+    ASSERT_EQ(result.size(), item_count);
+    for (std::size_t i = 0; i != item_count; ++i) {
+        EXPECT_EQ(result[i], i * i);
+    }
+    EXPECT_LE(max_in_flight.load(), limit);
+
+    background_executor.wait_idle();
+}
+
+TEST(thread, parallelReduce) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    constexpr std::size_t item_count = 100'000;
+
+    std::vector<std::size_t> items(item_count);
+    const auto maybe_for = parallel_for(
+                               background_executor,
+                               std::views::iota(std::size_t{ 0 }, item_count),
+                               0,
+                               [&items](std::size_t i) { items[i] = i; }
+                           )
+                           | get<default_event>();
+    ASSERT_TRUE(maybe_for.has_value());
+
+    const auto maybe_sum = parallel_reduce(background_executor, items, 0, std::size_t{ 0 }, std::plus<>{})
+                           | get<default_event>();
+    ASSERT_TRUE(maybe_sum.has_value());
+    EXPECT_EQ(maybe_sum->value(), item_count * (item_count - 1) / 2);
+
+    const auto maybe_scan = parallel_inclusive_scan(background_executor, items, items, 64, std::plus<>{})
+                            | get<default_event>();
+    ASSERT_TRUE(maybe_scan.has_value());
+    for (std::size_t i = 0; i != item_count; ++i) {
+        ASSERT_EQ(items[i], i * (i + 1) / 2);
+    }
+
+    background_executor.wait_idle();
+}
+
+TEST(thread, forkConcurrentSubscribers) {
+    monolithic_thread_pool background_executor{ thread_pool_config::with_hw_limit(4u) };
+    constexpr int iteration_count = 1000;
+
+    std::atomic<int> sum = 0;
+    for (int i = 0; i != iteration_count; ++i) {
+        auto [a, b, c] = schedule(background_executor, [] { return meta::ok(1); }) | fork<3>();
+        auto add = [&sum](int x) {
+            sum.fetch_add(x);
+            return meta::unit{};
+        };
+        std::move(a) | continue_on(background_executor) | map(add) | detach();
+        start_on(background_executor) //
+            | map([b = std::move(b)](meta::unit) mutable { return std::move(b); })
+            | flatten()
+            | map(add)
+            | detach();
+        std::move(c) | map(add) | detach();
+    }
+
+    background_executor.wait_idle();
+    EXPECT_EQ(sum.load(), 3 * iteration_count);
+}
+
+TEST(thread, streamMergeChannels) {
+    constexpr int iteration_count = 10'000;
+    auto channel1 = make_channel<int>();
+    auto channel2 = make_channel<int>();
+
+    const auto produce = [](auto& a_channel, int from) {
+        return std::thread{ [&a_channel, from] {
+            for (int i = from; i < 2 * iteration_count; i += 2) {
+                a_channel->send(int{ i }) | detach();
+            }
+            a_channel->close() | detach();
+        } };
+    };
+    std::thread producer1 = produce(channel1, 0);
+    std::thread producer2 = produce(channel2, 1);
+
+    const auto maybe_result = merge(as_stream(*channel1), as_stream(*channel2)) //
+                              | batch(64)
+                              | map([](std::vector<int> values) {
+                                    return std::accumulate(values.begin(), values.end(), 0L);
+                                })
+                              | collect()
+                              | get<default_event>();
+    producer1.join();
+    producer2.join();
+
+    ASSERT_TRUE(maybe_result.has_value());
+    const std::vector<long>& sums = maybe_result.value().value();
+    const long sum = std::accumulate(sums.begin(), sums.end(), 0L);
+    EXPECT_EQ(sum, long{ 2 * iteration_count - 1 } * iteration_count);
+}
+
+TEST(thread, shardedWaitGroup) {
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 1'000;
+    sharded_wait_group<detail::atomic> wg{ thread_count };
+    wg.add(0, thread_count * iterations);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&wg, t] {
+            for (std::size_t i = 0; i != iterations; ++i) {
+                wg.done(t);
+            }
+        });
+    }
+    wg.wait();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 namespace detail {
 
 TEST(threadDetail, taggedPtr) {
@@ -59,6 +442,288 @@ TEST(threadDetail, taggedPtr) {
 #endif
 }
 
+TEST(threadDetailHazard, protectedIsNotReclaimed) {
+    struct test_struct {
+        int& destroyed;
+        ~test_struct() { ++destroyed; }
+    };
+
+    int destroyed = 0;
+    detail::atomic<test_struct*> src{ new test_struct{ destroyed } };
+
+    auto guard = hazard_domain<>::make_guard();
+    test_struct* protected_ptr = guard.protect(src);
+    ASSERT_EQ(protected_ptr, src.load());
+
+    hazard_domain<>::retire(src.exchange(nullptr));
+    hazard_domain<>::reclaim();
+    ASSERT_EQ(destroyed, 0);
+
+    guard.reset();
+    hazard_domain<>::reclaim();
+    ASSERT_EQ(destroyed, 1);
+}
+
+TEST(threadDetailHazard, lockFreeStackPopConcurrent) {
+    struct test_node : meta::intrusive_forward_list_node<test_node> {
+        std::size_t value;
+    };
+
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t node_count = 10'000;
+    using stack_type = lock_free_stack<test_node>;
+    stack_type stack;
+
+    std::array<std::vector<std::size_t>, thread_count> popped;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&stack, &popped = popped[t], t] {
+            for (std::size_t i = 0; i != node_count; ++i) {
+                auto* node = new test_node{};
+                node->value = t * node_count + i;
+                stack.push(node);
+
+                if (stack_type::node_type* maybe_node = stack.pop(); maybe_node != nullptr) {
+                    popped.push_back(static_cast<test_node*>(maybe_node)->value);
+                    stack_type::retire(maybe_node);
+                }
+            }
+            hazard_domain<>::reclaim();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::size_t> all;
+    for (const auto& some : popped) {
+        all.insert(all.end(), some.begin(), some.end());
+    }
+    for (stack_type::node_type* node = stack.pop(); node != nullptr; node = stack.pop()) {
+        all.push_back(static_cast<test_node*>(node)->value);
+        stack_type::retire(node);
+    }
+    hazard_domain<>::reclaim();
+
+    std::ranges::sort(all);
+    ASSERT_EQ(all.size(), thread_count * node_count);
+    for (std::size_t i = 0; i != all.size(); ++i) {
+        ASSERT_EQ(all[i], i);
+    }
+}
+
+template <typename T>
+struct test_counting_allocator {
+    using value_type = T;
+
+    explicit test_counting_allocator(int& allocations) : allocations_{ &allocations } {}
+    template <typename U>
+    test_counting_allocator(const test_counting_allocator<U>& other) : allocations_{ other.allocations_ } {}
+
+    T* allocate(std::size_t n) {
+        ++*allocations_;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* ptr, std::size_t n) {
+        --*allocations_;
+        std::allocator<T>{}.deallocate(ptr, n);
+    }
+
+    int* allocations_;
+};
+
+TEST(threadDetailArc, customAllocator) {
+    int allocations = 0;
+    {
+        auto a = arc<std::string>::allocate(test_counting_allocator<char>{ allocations }, "value");
+        ASSERT_EQ(allocations, 1);
+        auto b = a;
+        ASSERT_EQ(*b, "value");
+    }
+    ASSERT_EQ(allocations, 0);
+}
+
+TEST(threadDetailArc, deferredRelease) {
+    struct test_struct {
+        int& destroyed;
+        ~test_struct() { ++destroyed; }
+    };
+
+    int destroyed = 0;
+    {
+        auto a = arc<test_struct, detail::atomic, arc_release::deferred>::make(destroyed);
+        auto b = a;
+    }
+    ASSERT_EQ(destroyed, 0);
+
+    arc_flush_deferred();
+    ASSERT_EQ(destroyed, 1);
+}
+
+TEST(threadDetailArc, moveAssignment) {
+    auto a = arc<int>::make(1);
+    auto b = arc<int>::make(2);
+    a = std::move(b);
+    ASSERT_EQ(*a, 2);
+}
+
+TEST(threadDetailArc, weakUpgrade) {
+    struct test_struct {
+        int& destroyed;
+        ~test_struct() { ++destroyed; }
+    };
+
+    int destroyed = 0;
+    auto maybe_weak = [&] {
+        auto strong = arc<test_struct>::make(destroyed);
+        weak_arc<test_struct> weak{ strong };
+        {
+            auto upgraded = weak.upgrade();
+            EXPECT_TRUE(upgraded.has_value());
+            EXPECT_EQ(&(*upgraded)->destroyed, &destroyed);
+        }
+        return weak;
+    }();
+    ASSERT_EQ(destroyed, 1);
+    ASSERT_FALSE(maybe_weak.upgrade().has_value());
+}
+
+TEST(threadDetailArc, weakBreaksCycle) {
+    struct test_node {
+        int& destroyed;
+        meta::maybe<weak_arc<test_node>> parent{};
+        meta::maybe<arc<test_node>> child{};
+        ~test_node() { ++destroyed; }
+    };
+
+    int destroyed = 0;
+    {
+        auto parent = arc<test_node>::make(destroyed);
+        auto child = arc<test_node>::make(destroyed);
+        child->parent.emplace(parent);
+        parent->child.emplace(std::move(child));
+    }
+    ASSERT_EQ(destroyed, 2);
+}
+
+TEST(threadDetailArc, intrusive) {
+    struct test_struct : intrusive_arc_base<test_struct> {
+        test_struct(int& destroyed) : destroyed_{ destroyed } {}
+        ~test_struct() { ++destroyed_; }
+
+        int& destroyed_;
+    };
+
+    int destroyed = 0;
+    {
+        auto a = intrusive_arc<test_struct>::make(destroyed);
+        auto b = a;
+        auto c = intrusive_arc<test_struct>::make(destroyed);
+        c = std::move(b);
+        ASSERT_EQ(destroyed, 1);
+        ASSERT_EQ(&a->destroyed_, &c->destroyed_);
+    }
+    ASSERT_EQ(destroyed, 2);
+}
+
+TEST(threadDetailMpscQueue, fifoPerProducer) {
+    struct test_node : meta::intrusive_forward_list_node<test_node> {
+        std::size_t producer;
+        std::size_t value;
+    };
+
+    constexpr std::size_t producer_count = 4;
+    constexpr std::size_t node_count = 10'000;
+    mpsc_queue<test_node> queue;
+    std::vector<test_node> nodes(producer_count * node_count);
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p != producer_count; ++p) {
+        producers.emplace_back([&queue, &nodes, p] {
+            for (std::size_t i = 0; i != node_count; ++i) {
+                test_node& node = nodes[p * node_count + i];
+                node.producer = p;
+                node.value = i;
+                queue.push(&node);
+            }
+        });
+    }
+
+    std::array<std::size_t, producer_count> expected{};
+    std::size_t popped = 0;
+    while (popped != producer_count * node_count) {
+        auto* node = queue.try_pop();
+        if (node == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        auto& a_test_node = *node->downcast();
+        ASSERT_EQ(a_test_node.value, expected[a_test_node.producer]++);
+        ++popped;
+    }
+    ASSERT_EQ(queue.try_pop(), nullptr);
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+
+TEST(threadDetailFutex, mutexExclusive) {
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 10'000;
+
+    futex_mutex m;
+    std::size_t counter = 0;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i != iterations; ++i) {
+                std::lock_guard lock{ m };
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(counter, thread_count * iterations);
+}
+
+TEST(threadDetailFutex, blockingQueue) {
+    struct test_node : meta::intrusive_forward_list_node<test_node> {
+        std::size_t value;
+    };
+
+    constexpr std::size_t node_count = 1'000;
+    unbound_blocking_queue<test_node, futex_mutex, futex_condition_variable> queue;
+    std::vector<test_node> nodes(node_count);
+
+    std::thread consumer{ [&] {
+        std::size_t expected = 0;
+        while (auto* node = queue.try_pop()) {
+            EXPECT_EQ(static_cast<test_node*>(node)->value, expected++);
+        }
+        EXPECT_EQ(expected, node_count);
+    } };
+    for (std::size_t i = 0; i != node_count; ++i) {
+        nodes[i].value = i;
+        ASSERT_TRUE(queue.push(&nodes[i]));
+    }
+    queue.close();
+    consumer.join();
+}
+
+TEST(threadDetailFutex, event) {
+    futex_event event;
+    std::thread setter{ [&event] { event.set(); } };
+    event.wait();
+    setter.join();
+
+    futex_event already_set;
+    already_set.set();
+    already_set.wait();
+}
+
 struct test_descriptor {
     // concept requirements
     static constexpr mw::pointer_type max_threads = 1;